@@ -0,0 +1,62 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "allocations.hpp"
+
+// the global allocation functions are replaced to count heap allocations of the benchmarks. The over-aligned
+// versions are left to the standard library, they aren't used by co_lib
+
+namespace
+{
+
+std::atomic<uint64_t> n_allocations = 0;
+
+void* allocate(std::size_t size)
+{
+    n_allocations.fetch_add(1, std::memory_order::relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+namespace bench
+{
+
+uint64_t heap_allocations() noexcept
+{
+    return n_allocations.load(std::memory_order::relaxed);
+}
+
+}  // namespace bench
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <co/co.hpp>
+
+namespace bench
+{
+
+/// \brief get the number of calls of the global operator new made by all OS threads of the process
+uint64_t heap_allocations() noexcept;
+
+/// \brief counts heap allocations and coroutine frames of the current OS thread made since construction
+///
+/// Usage:
+/// \code
+///     bench::allocation_counter allocations;
+///     for (auto _ : state)
+///         do_work();
+///     allocations.report(state);
+/// \endcode
+class allocation_counter
+{
+public:
+    allocation_counter()
+        : _heap(heap_allocations())
+        , _frames(co::get_frame_allocator_stats().allocations)
+    {}
+
+    /// \brief adds "allocs" (global operator new calls) and "frames" (coroutine frames, pooled or not) per iteration
+    /// counters to the benchmark results
+    void report(benchmark::State& state) const
+    {
+        const auto heap = heap_allocations() - _heap;
+        const auto frames = co::get_frame_allocator_stats().allocations - _frames;
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(heap), benchmark::Counter::kAvgIterations);
+        state.counters["frames"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    uint64_t _heap;
+    size_t _frames;
+};
+
+}  // namespace bench
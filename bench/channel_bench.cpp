@@ -0,0 +1,487 @@
+#include <thread>
+#include <benchmark/benchmark.h>
+#include <co/co.hpp>
+#include "allocations.hpp"
+
+namespace
+{
+
+// answers every ping with value + 1 until the ping channel is closed
+co::func<void> ponger(co::channel<int> ping, co::channel<int> pong)
+{
+    while (true)
+    {
+        auto res = co_await ping.pop();
+        if (res.is_err())
+            break;
+        (co_await pong.push(res.unwrap() + 1)).unwrap();
+    }
+}
+
+// sends pings until the stop channel is closed
+co::func<void> pinger(co::channel<int> ping, co::channel<int> pong, co::channel<int> stop)
+{
+    int value = 0;
+    while (!stop.is_closed())
+    {
+        (co_await ping.push(value)).unwrap();
+        value = (co_await pong.pop()).unwrap();
+    }
+    ping.close();
+}
+
+}  // namespace
+
+// round trip of a message between two co::threads over a pair of channels. The argument is the number of other
+// ping-pong pairs running at the same time
+static void BM_channel_ping_pong(benchmark::State& state)
+{
+    const auto n_background = static_cast<size_t>(state.range(0));
+    co::loop(
+        [&state, n_background]() -> co::func<void>
+        {
+            co::channel<int> stop(1);
+            std::vector<co::thread> threads;
+            for (size_t i = 0; i < n_background; i++)
+            {
+                co::channel<int> ping(1);
+                co::channel<int> pong(1);
+                threads.emplace_back(ponger(ping, pong));
+                threads.emplace_back(pinger(ping, pong, stop));
+            }
+
+            co::channel<int> ping(1);
+            co::channel<int> pong(1);
+            threads.emplace_back(ponger(ping, pong));
+
+            int value = 0;
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                (co_await ping.push(value)).unwrap();
+                value = (co_await pong.pop()).unwrap();
+            }
+            allocations.report(state);
+            ping.close();
+            stop.close();
+            for (auto& th : threads)
+                co_await th.join();
+            benchmark::DoNotOptimize(value);
+        });
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_channel_ping_pong)->Arg(0)->Arg(100);
+
+// a co::thread pushes values as fast as possible, another co::thread pops them. The argument is the channel capacity
+// (the soft limit of an unbounded channel), 0 is a rendezvous channel
+template <typename Channel>
+static void BM_channel_throughput(benchmark::State& state)
+{
+    const auto capacity = static_cast<size_t>(state.range(0));
+    co::loop(
+        [&state, capacity]() -> co::func<void>
+        {
+            Channel ch(capacity);
+            auto consumer = co::thread(
+                [ch]() mutable -> co::func<void>
+                {
+                    while (true)
+                    {
+                        auto res = co_await ch.pop();
+                        if (res.is_err())
+                            break;
+                    }
+                });
+
+            int value = 0;
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                auto res = co_await ch.push(value++);
+                res.unwrap();
+            }
+            allocations.report(state);
+            ch.close();
+            co_await consumer.join();
+        });
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_channel_throughput, co::channel<int>)->Arg(0)->Arg(1)->Arg(16)->Arg(256);
+BENCHMARK_TEMPLATE(BM_channel_throughput, co::unbounded_channel<int>)->Arg(16)->Arg(256)->Arg(100000);
+
+// the same as BM_channel_throughput for a channel of capacity 256, but the values are pushed with push_many and
+// popped with pop_many. The argument is the batch size
+static void BM_channel_batch_throughput(benchmark::State& state)
+{
+    const auto batch_size = static_cast<size_t>(state.range(0));
+    co::loop(
+        [&state, batch_size]() -> co::func<void>
+        {
+            co::channel<int> ch(256);
+            auto consumer = co::thread(
+                [ch, batch_size]() mutable -> co::func<void>
+                {
+                    std::vector<int> batch(batch_size);
+                    while ((co_await ch.pop_many(batch.begin(), batch.size())).is_ok())
+                    {}
+                });
+
+            std::vector<int> batch(batch_size);
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                auto res = co_await ch.push_many(batch);
+                res.unwrap();
+            }
+            allocations.report(state);
+            ch.close();
+            co_await consumer.join();
+        });
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_channel_batch_throughput)->Arg(1)->Arg(16)->Arg(256);
+
+// a std::thread pushes values with blocking_push, a co::thread pops them. The argument is the channel capacity
+template <typename Channel>
+static void BM_channel_from_std_thread(benchmark::State& state)
+{
+    const auto capacity = static_cast<size_t>(state.range(0));
+    Channel ch(capacity);
+    std::thread producer(
+        [ch]() mutable
+        {
+            int value = 0;
+            while (ch.blocking_push(value++).is_ok())
+            {}
+        });
+
+    co::loop(
+        [&state, ch]() mutable -> co::func<void>
+        {
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                auto res = co_await ch.pop();
+                benchmark::DoNotOptimize(res);
+            }
+            allocations.report(state);
+            ch.close();
+        });
+    producer.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_channel_from_std_thread, co::ts_channel<int>)->Arg(1)->Arg(256)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_channel_from_std_thread, co::spsc_channel<int>)->Arg(1)->Arg(256)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_channel_from_std_thread, co::mpmc_channel<int>)->Arg(1)->Arg(256)->UseRealTime();
+
+// a co::thread pushes values, a std::thread pops them with blocking_pop. The argument is the channel capacity
+template <typename Channel>
+static void BM_channel_to_std_thread(benchmark::State& state)
+{
+    const auto capacity = static_cast<size_t>(state.range(0));
+    Channel ch(capacity);
+    std::thread consumer(
+        [ch]() mutable
+        {
+            while (ch.blocking_pop().is_ok())
+            {}
+        });
+
+    co::loop(
+        [&state, ch]() mutable -> co::func<void>
+        {
+            int value = 0;
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                auto res = co_await ch.push(value++);
+                res.unwrap();
+            }
+            allocations.report(state);
+            ch.close();
+        });
+    consumer.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_channel_to_std_thread, co::ts_channel<int>)->Arg(1)->Arg(256)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_channel_to_std_thread, co::spsc_channel<int>)->Arg(1)->Arg(256)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_channel_to_std_thread, co::mpmc_channel<int>)->Arg(1)->Arg(256)->UseRealTime();
+
+// several std::threads push values with blocking_push into a channel of capacity 256, a co::thread pops them. The
+// argument is the number of producers
+template <typename Channel>
+static void BM_channel_many_producers(benchmark::State& state)
+{
+    const auto n_producers = static_cast<size_t>(state.range(0));
+    Channel ch(256);
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < n_producers; i++)
+    {
+        producers.emplace_back(
+            [ch]() mutable
+            {
+                int value = 0;
+                while (ch.blocking_push(value++).is_ok())
+                {}
+            });
+    }
+
+    co::loop(
+        [&state, ch]() mutable -> co::func<void>
+        {
+            for (auto _ : state)
+            {
+                auto res = co_await ch.pop();
+                benchmark::DoNotOptimize(res);
+            }
+            ch.close();
+        });
+    for (auto& producer : producers)
+        producer.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_channel_many_producers, co::ts_channel<int>)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_channel_many_producers, co::mpmc_channel<int>)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+// several std::threads push batches of 64 values with blocking_push into a ts_channel of capacity 256, a co::thread
+// pops them with pop_many. The argument is the number of producers
+static void BM_ts_channel_batch_many_producers(benchmark::State& state)
+{
+    constexpr size_t batch_size = 64;
+    const auto n_producers = static_cast<size_t>(state.range(0));
+    co::ts_channel<int> ch(256);
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < n_producers; i++)
+    {
+        producers.emplace_back(
+            [ch]() mutable
+            {
+                co::loop(
+                    [ch]() mutable -> co::func<void>
+                    {
+                        std::vector<int> batch(batch_size);
+                        while ((co_await ch.push_many(batch)).is_ok())
+                        {}
+                    });
+            });
+    }
+
+    co::loop(
+        [&state, ch]() mutable -> co::func<void>
+        {
+            std::vector<int> batch(batch_size);
+            int64_t n_items = 0;
+            for (auto _ : state)
+            {
+                auto res = co_await ch.pop_many(batch.begin(), batch.size());
+                n_items += static_cast<int64_t>(res.unwrap());
+            }
+            state.SetItemsProcessed(n_items);
+            ch.close();
+        });
+    for (auto& producer : producers)
+        producer.join();
+}
+BENCHMARK(BM_ts_channel_batch_many_producers)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+// a co::thread pushes values to several channels of capacity 16 in turn, another co::thread receives them with one
+// co::select. The argument is the number of channels
+static void BM_channel_select(benchmark::State& state)
+{
+    const auto n_channels = static_cast<size_t>(state.range(0));
+    co::loop(
+        [&state, n_channels]() -> co::func<void>
+        {
+            std::vector<co::channel<int>> channels;
+            for (size_t i = 0; i < n_channels; i++)
+                channels.emplace_back(16);
+            co::event stop;
+            auto consumer = co::thread(
+                [&channels, &stop]() -> co::func<void>
+                {
+                    std::optional<int> a;
+                    std::optional<int> b;
+                    std::optional<int> c;
+                    std::optional<int> d;
+                    while (true)
+                    {
+                        auto res = channels.size() == 2
+                                       ? co_await co::select(co::recv(channels[0], a), co::recv(channels[1], b), stop)
+                                       : co_await co::select(co::recv(channels[0], a),
+                                                             co::recv(channels[1], b),
+                                                             co::recv(channels[2], c),
+                                                             co::recv(channels[3], d),
+                                                             stop);
+                        if (res.unwrap() == channels.size())
+                            break;
+                    }
+                });
+
+            int value = 0;
+            size_t next = 0;
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                auto res = co_await channels[next].push(value++);
+                res.unwrap();
+                next = (next + 1) % n_channels;
+            }
+            allocations.report(state);
+            stop.notify();
+            co_await consumer.join();
+        });
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_channel_select)->Arg(2)->Arg(4);
+
+// a co::thread delivers every message to several consumer co::threads: through one broadcast_channel or through a
+// channel per consumer. The argument is the number of consumers
+template <bool Broadcast>
+static void BM_channel_fan_out(benchmark::State& state)
+{
+    const auto n_consumers = static_cast<size_t>(state.range(0));
+    co::loop(
+        [&state, n_consumers]() -> co::func<void>
+        {
+            co::broadcast_channel<int> broadcast(256);
+            std::vector<co::channel<int>> channels;
+            std::vector<co::thread> consumers;
+            for (size_t i = 0; i < n_consumers; i++)
+            {
+                if constexpr (Broadcast)
+                {
+                    consumers.emplace_back(
+                        [sub = broadcast.subscribe()]() mutable -> co::func<void>
+                        {
+                            while ((co_await sub.pop()) != co::closed)
+                            {}
+                        });
+                }
+                else
+                {
+                    channels.emplace_back(256);
+                    consumers.emplace_back(
+                        [ch = channels.back()]() mutable -> co::func<void>
+                        {
+                            while ((co_await ch.pop()) != co::closed)
+                            {}
+                        });
+                }
+            }
+
+            int value = 0;
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                if constexpr (Broadcast)
+                {
+                    broadcast.push(value++).unwrap();
+                    // let the consumers keep up, otherwise they lag
+                    co_await co::this_thread::yield();
+                }
+                else
+                {
+                    for (auto& ch : channels)
+                    {
+                        auto res = co_await ch.push(value);
+                        res.unwrap();
+                    }
+                    value++;
+                    co_await co::this_thread::yield();
+                }
+            }
+            allocations.report(state);
+            broadcast.close();
+            for (auto& ch : channels)
+                ch.close();
+            for (auto& th : consumers)
+                co_await th.join();
+        });
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_channel_fan_out, true)->Arg(10)->Arg(500);
+BENCHMARK_TEMPLATE(BM_channel_fan_out, false)->Arg(10)->Arg(500);
+
+// a co::thread publishes versions of a value, another co::thread waits for the changes with co::watch or drains a
+// channel of capacity 1 by hand. Both get the latest value
+template <bool Watch>
+static void BM_latest_value(benchmark::State& state)
+{
+    co::loop(
+        [&state]() -> co::func<void>
+        {
+            co::watch<int> w(0);
+            co::channel<int> ch(1);
+            auto reader = co::thread(
+                [rx = w.subscribe(), ch]() mutable -> co::func<void>
+                {
+                    int latest = 0;
+                    while (true)
+                    {
+                        if constexpr (Watch)
+                        {
+                            auto res = co_await rx.changed();
+                            if (res.is_err())
+                                break;
+                            latest = res.unwrap();
+                        }
+                        else
+                        {
+                            auto res = co_await ch.pop();
+                            if (res.is_err())
+                                break;
+                            latest = res.unwrap();
+                            for (auto stale = ch.try_pop(); stale.is_ok(); stale = ch.try_pop())
+                                latest = stale.unwrap();
+                        }
+                    }
+                    benchmark::DoNotOptimize(latest);
+                });
+
+            int value = 0;
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                if constexpr (Watch)
+                {
+                    w.publish(++value).unwrap();
+                }
+                else
+                {
+                    // replace the stale value
+                    auto stale = ch.try_pop();
+                    benchmark::DoNotOptimize(stale);
+                    ch.try_push(++value).unwrap();
+                }
+                co_await co::this_thread::yield();
+            }
+            allocations.report(state);
+            w.close();
+            ch.close();
+            co_await reader.join();
+        });
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_latest_value, true);
+BENCHMARK_TEMPLATE(BM_latest_value, false);
+
+// a co::thread pushes values into a full lossy channel of capacity 256 without a consumer, every push drops a value
+template <co::overflow_policy Overflow>
+static void BM_lossy_channel_push(benchmark::State& state)
+{
+    co::loop(
+        [&state]() -> co::func<void>
+        {
+            co::lossy_channel<int, Overflow> ch(256);
+            int value = 0;
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+                ch.try_push(value++).unwrap();
+            allocations.report(state);
+            benchmark::DoNotOptimize(ch.dropped());
+            co_return;
+        });
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_lossy_channel_push, co::overflow_policy::drop_oldest);
+BENCHMARK_TEMPLATE(BM_lossy_channel_push, co::overflow_policy::drop_newest);
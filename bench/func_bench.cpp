@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+#include <co/co.hpp>
+#include "allocations.hpp"
+
+namespace
+{
+
+co::func<int> nested(int depth)
+{
+    if (depth == 0)
+        co_return 0;
+    co_return co_await nested(depth - 1) + 1;
+}
+
+}  // namespace
+
+// a chain of nested co::func calls, each call creates a coroutine frame
+static void BM_func_nested_calls(benchmark::State& state)
+{
+    const auto depth = static_cast<int>(state.range(0));
+    co::loop(
+        [&state, depth]() -> co::func<void>
+        {
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+                benchmark::DoNotOptimize(co_await nested(depth));
+            allocations.report(state);
+        });
+    state.SetItemsProcessed(state.iterations() * (state.range(0) + 1));
+}
+BENCHMARK(BM_func_nested_calls)->Arg(1)->Arg(8)->Arg(64);
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+#include <co/co.hpp>
+#include "allocations.hpp"
+
+// lock + unlock of a mutex nobody else wants
+static void BM_mutex_no_contention(benchmark::State& state)
+{
+    co::loop(
+        [&state]() -> co::func<void>
+        {
+            co::mutex mtx;
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                co_await mtx.lock();
+                mtx.unlock();
+            }
+            allocations.report(state);
+        });
+}
+BENCHMARK(BM_mutex_no_contention);
+
+// co::threads hold the mutex across a suspension point, so every lock waits in the queue of the mutex. The argument
+// is the number of other co::threads contending for the mutex
+static void BM_mutex_contention(benchmark::State& state)
+{
+    const auto n_contenders = static_cast<size_t>(state.range(0));
+    co::loop(
+        [&state, n_contenders]() -> co::func<void>
+        {
+            co::mutex mtx;
+            bool stop = false;
+            std::vector<co::thread> threads;
+            for (size_t i = 0; i < n_contenders; i++)
+            {
+                threads.emplace_back(
+                    [&mtx, &stop]() -> co::func<void>
+                    {
+                        while (!stop)
+                        {
+                            co_await mtx.lock();
+                            co_await co::this_thread::yield();
+                            mtx.unlock();
+                        }
+                    });
+            }
+            // let the contenders start
+            co_await co::this_thread::yield();
+
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                co_await mtx.lock();
+                co_await co::this_thread::yield();
+                mtx.unlock();
+            }
+            allocations.report(state);
+            stop = true;
+            for (auto& th : threads)
+                co_await th.join();
+        });
+    state.SetItemsProcessed(state.iterations() * (state.range(0) + 1));
+}
+BENCHMARK(BM_mutex_contention)->Arg(1)->Arg(16);
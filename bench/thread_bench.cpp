@@ -0,0 +1,113 @@
+#include <optional>
+#include <benchmark/benchmark.h>
+#include <co/co.hpp>
+#include "allocations.hpp"
+
+// spawn + join of an empty co::thread. Expected to be well below 1us per iteration
+static void BM_thread_spawn_join(benchmark::State& state)
+{
+    co::loop(
+        [&state]() -> co::func<void>
+        {
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                auto th = co::thread([]() -> co::func<void> { co_return; });
+                co_await th.join();
+            }
+            allocations.report(state);
+        });
+}
+BENCHMARK(BM_thread_spawn_join);
+
+// spawn a batch of co::threads, then join all of them
+static void BM_thread_spawn_join_batch(benchmark::State& state)
+{
+    const auto batch_size = static_cast<size_t>(state.range(0));
+    co::loop(
+        [&state, batch_size]() -> co::func<void>
+        {
+            std::vector<co::thread> threads;
+            threads.reserve(batch_size);
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                for (size_t i = 0; i < batch_size; i++)
+                    threads.emplace_back([]() -> co::func<void> { co_return; });
+                for (auto& th : threads)
+                    co_await th.join();
+                threads.clear();
+            }
+            allocations.report(state);
+        });
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_thread_spawn_join_batch)->Arg(100)->Arg(10000);
+
+// a co::thread notifies an event another co::thread waits for, then waits to be notified back
+static void BM_event_notify_wait(benchmark::State& state)
+{
+    co::loop(
+        [&state]() -> co::func<void>
+        {
+            // events are one shot, each side recreates the event it waits for before notifying the other side
+            std::optional<co::event> ping;
+            std::optional<co::event> pong;
+            bool stop = false;
+            ping.emplace();
+            auto responder = co::thread(
+                [&]() -> co::func<void>
+                {
+                    while (true)
+                    {
+                        co_await ping->wait();
+                        if (stop)
+                            break;
+                        ping.emplace();
+                        pong->notify();
+                    }
+                });
+
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                pong.emplace();
+                ping->notify();
+                co_await pong->wait();
+            }
+            allocations.report(state);
+            stop = true;
+            ping->notify();
+            co_await responder.join();
+        });
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_event_notify_wait);
+
+// wait with a timeout on an event which is already notified. Arms and cancels a timer of the timer wheel
+static void BM_event_wait_with_timeout(benchmark::State& state)
+{
+    using namespace std::chrono_literals;
+    co::loop(
+        [&state]() -> co::func<void>
+        {
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                co::event ev;
+                auto notifier = co::thread(
+                    [&ev]() -> co::func<void>
+                    {
+                        ev.notify();
+                        co_return;
+                    });
+                auto res = co_await ev.wait({ 1s });
+                benchmark::DoNotOptimize(res);
+                co_await notifier.join();
+            }
+            allocations.report(state);
+        });
+}
+BENCHMARK(BM_event_wait_with_timeout);
+
+BENCHMARK_MAIN();
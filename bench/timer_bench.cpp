@@ -0,0 +1,70 @@
+#include <optional>
+#include <benchmark/benchmark.h>
+#include <co/co.hpp>
+#include "allocations.hpp"
+
+using namespace std::chrono_literals;
+
+// co::threads sleep for 1ms at the same time, so their timers expire in one tick of the timer wheel. The argument is
+// the number of sleeping co::threads
+static void BM_sleep_for(benchmark::State& state)
+{
+    const auto n_sleepers = static_cast<size_t>(state.range(0));
+    co::loop(
+        [&state, n_sleepers]() -> co::func<void>
+        {
+            std::vector<co::thread> threads;
+            threads.reserve(n_sleepers);
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                for (size_t i = 0; i < n_sleepers; i++)
+                    threads.emplace_back([]() -> co::func<void> { co_await co::this_thread::sleep_for(1ms); });
+                for (auto& th : threads)
+                    co_await th.join();
+                threads.clear();
+            }
+            allocations.report(state);
+        });
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sleep_for)->Arg(1)->Arg(1000)->UseRealTime();
+
+// timeouts which never expire: each wait arms a timer and cancels it when the event is notified. The argument is the
+// number of other long timers in the timer wheel
+static void BM_timeout_churn(benchmark::State& state)
+{
+    const auto n_pending = static_cast<size_t>(state.range(0));
+    co::loop(
+        [&state, n_pending]() -> co::func<void>
+        {
+            co::stop_source stop;
+            std::vector<co::thread> threads;
+            for (size_t i = 0; i < n_pending; i++)
+            {
+                threads.emplace_back(
+                    [token = stop.get_token()]() -> co::func<void>
+                    { co_await co::this_thread::sleep_for(1h, token); });
+            }
+
+            // let the sleepers arm their timers
+            co_await co::this_thread::yield();
+
+            std::optional<co::event> ev;
+            bench::allocation_counter allocations;
+            for (auto _ : state)
+            {
+                ev.emplace();
+                auto waiter = co::thread([&ev]() -> co::func<void> { co_await ev->wait({ 1s }); });
+                // let the waiter arm the timer
+                co_await co::this_thread::yield();
+                ev->notify();
+                co_await waiter.join();
+            }
+            allocations.report(state);
+            stop.request_stop();
+            for (auto& th : threads)
+                co_await th.join();
+        });
+}
+BENCHMARK(BM_timeout_churn)->Arg(0)->Arg(10000);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <charconv>
+#include <string_view>
+
+namespace tools
+{
+
+/// \brief parses the whole value as a number. Returns false if the value isn't a number or doesn't fit into Number
+template <typename Number>
+bool parse_number(std::string_view value, Number& number)
+{
+    const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+    return ec == std::errc{} && ptr == value.data() + value.size();
+}
+
+/// \brief calls on_option(name, value) for every `--name=value` argument of the command line. Returns false if an
+/// argument has another form or on_option returns false
+///
+/// Usage:
+/// \code
+///     size_t connections = 64;
+///     const bool ok = tools::parse_options(argc, argv, [&](std::string_view name, std::string_view value) {
+///         return name == "connections" && tools::parse_number(value, connections);
+///     });
+/// \endcode
+template <typename OnOption>
+bool parse_options(int argc, char** argv, OnOption&& on_option)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        const auto eq = arg.find('=');
+        if (!arg.starts_with("--") || eq == std::string_view::npos)
+            return false;
+        if (!on_option(arg.substr(2, eq - 2), arg.substr(eq + 1)))
+            return false;
+    }
+    return true;
+}
+
+}  // namespace tools
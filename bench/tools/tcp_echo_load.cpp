@@ -0,0 +1,364 @@
+// TCP echo load generator: drives co::net::tcp_stream connections against an echo server built on
+// co::net::tcp_listener and reports throughput and the latency distribution of the requests.
+//
+// Usage:
+//     co_lib_tcp_echo_load [--mode=both|server|client] [--host=127.0.0.1] [--port=50008] [--connections=64]
+//                          [--size=64] [--pipeline=1] [--duration=10]
+//
+// --mode=both (the default) runs the server and the clients in two event loops of one process, --mode=server and
+// --mode=client run one side only, e.g. to put them on different machines. --pipeline is the number of requests a
+// connection sends without waiting for the responses, --duration is in seconds.
+
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <co/co.hpp>
+#include <co/net/net.hpp>
+
+#include "options.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+struct options
+{
+    std::string mode = "both";
+    std::string host = "127.0.0.1";
+    uint16_t port = 50008;
+    size_t connections = 64;
+    size_t size = 64;
+    size_t pipeline = 1;
+    size_t duration = 10;
+};
+
+/// \brief histogram of the HDR kind: each power of two range is split into linear sub buckets, so the relative error
+/// of a reported value doesn't depend on the value and is below 1 / (sub_bucket_count / 2)
+class latency_histogram
+{
+    static constexpr size_t sub_bucket_bits = 8;
+    static constexpr uint64_t sub_bucket_count = uint64_t(1) << sub_bucket_bits;
+    static constexpr uint64_t half_count = sub_bucket_count / 2;
+
+public:
+    latency_histogram()
+        : _counts(sub_bucket_count + (64 - sub_bucket_bits) * half_count)
+    {}
+
+    void record(uint64_t value)
+    {
+        _counts[index(value)]++;
+        _total++;
+        _max = std::max(_max, value);
+    }
+
+    [[nodiscard]] uint64_t total() const
+    {
+        return _total;
+    }
+
+    [[nodiscard]] uint64_t max() const
+    {
+        return _max;
+    }
+
+    /// \brief get the highest value equivalent to the q-quantile (0 <= q <= 1)
+    [[nodiscard]] uint64_t percentile(double q) const
+    {
+        if (_total == 0)
+            return 0;
+        const auto rank = static_cast<uint64_t>(q * static_cast<double>(_total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < _counts.size(); i++)
+        {
+            seen += _counts[i];
+            if (seen >= rank)
+                return std::min(highest_equivalent(i), _max);
+        }
+        return _max;
+    }
+
+private:
+    static size_t index(uint64_t value)
+    {
+        if (value < sub_bucket_count)
+            return value;
+        const auto shift = static_cast<size_t>(std::bit_width(value)) - sub_bucket_bits;
+        return sub_bucket_count + (shift - 1) * half_count + ((value >> shift) - half_count);
+    }
+
+    static uint64_t highest_equivalent(size_t index)
+    {
+        if (index < sub_bucket_count)
+            return index;
+        const size_t shift = (index - sub_bucket_count) / half_count + 1;
+        const uint64_t mantissa = (index - sub_bucket_count) % half_count + half_count;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> _counts;
+    uint64_t _total = 0;
+    uint64_t _max = 0;
+};
+
+struct load_results
+{
+    latency_histogram latency;
+    uint64_t bytes = 0;
+    uint64_t errors = 0;
+    std::chrono::steady_clock::duration elapsed{};
+};
+
+bool parse_options(int argc, char** argv, options& opts)
+{
+    const bool parsed = tools::parse_options(argc,
+                                             argv,
+                                             [&opts](std::string_view name, std::string_view value)
+                                             {
+                                                 if (name == "mode")
+                                                 {
+                                                     opts.mode = value;
+                                                     return true;
+                                                 }
+                                                 if (name == "host")
+                                                 {
+                                                     opts.host = value;
+                                                     return true;
+                                                 }
+                                                 if (name == "port")
+                                                     return tools::parse_number(value, opts.port);
+                                                 if (name == "connections")
+                                                     return tools::parse_number(value, opts.connections);
+                                                 if (name == "size")
+                                                     return tools::parse_number(value, opts.size);
+                                                 if (name == "pipeline")
+                                                     return tools::parse_number(value, opts.pipeline);
+                                                 if (name == "duration")
+                                                     return tools::parse_number(value, opts.duration);
+                                                 return false;
+                                             });
+    return parsed && (opts.mode == "both" || opts.mode == "server" || opts.mode == "client") && opts.connections > 0 &&
+           opts.size > 0 && opts.pipeline > 0;
+}
+
+// echoes everything back until the peer shuts down its side
+co::func<void> serve_client(co::net::tcp_stream tcp)
+{
+    std::vector<char> buffer(64 * 1024);
+    while (true)
+    {
+        auto res = co_await tcp.read(buffer);
+        if (res.is_err())
+            break;
+        if ((co_await tcp.write(res.unwrap())).is_err())
+            break;
+    }
+    co_await tcp.shutdown();
+}
+
+co::func<void> server(const options& opts, co::ts_event* listening)
+{
+    auto listener = co_await co::net::tcp_listener::bind(opts.host, opts.port).unwrap();
+    if (listening != nullptr)
+        listening->notify();
+
+    auto token = co::this_thread::stop_token();
+    while (true)
+    {
+        auto res = co_await listener.accept(co::until::cancel(token));
+        if (res == co::cancel)
+            break;
+        co::thread(serve_client(std::move(res.unwrap()))).detach();
+    }
+}
+
+// sends requests until the deadline, up to opts.pipeline requests are in flight. A request is sent when the receiver
+// gives a credit back for a fully read response, the send time of each request in flight is kept in in_flight
+co::func<void> send_requests(co::net::tcp_stream& tcp,
+                             const options& opts,
+                             co::channel<int> credits,
+                             co::channel<std::chrono::steady_clock::time_point> in_flight,
+                             std::chrono::steady_clock::time_point deadline,
+                             load_results& results)
+{
+    const std::vector<char> request(opts.size, 'x');
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        if ((co_await credits.pop()).is_err())
+            break;
+        // the send time is taken after the credit, so waiting for the pipeline window isn't counted as latency
+        if (in_flight.try_push(std::chrono::steady_clock::now()).is_err())
+            break;
+        if ((co_await tcp.write(request)).is_err())
+        {
+            results.errors++;
+            break;
+        }
+    }
+    in_flight.close();
+}
+
+co::func<void> client_connection(const options& opts,
+                                 std::chrono::steady_clock::time_point deadline,
+                                 load_results& results)
+{
+    auto connected = co_await co::net::tcp_stream::connect(opts.host, opts.port);
+    if (connected.is_err())
+    {
+        results.errors++;
+        co_return;
+    }
+    auto tcp = std::move(connected.unwrap());
+
+    // there are never more than opts.pipeline credits and send times, so in_flight is never full
+    co::channel<int> credits(opts.pipeline);
+    for (size_t i = 0; i < opts.pipeline; i++)
+        credits.try_push(0).unwrap();
+    co::channel<std::chrono::steady_clock::time_point> in_flight(opts.pipeline);
+    auto sender = co::thread(send_requests(tcp, opts, credits, in_flight, deadline, results));
+
+    // responses come in the order of the requests, the message boundaries are restored by the fixed size
+    std::vector<char> buffer(std::max<size_t>(opts.size * opts.pipeline, 64 * 1024));
+    size_t received = 0;
+    while (true)
+    {
+        auto sent_at = co_await in_flight.pop();
+        if (sent_at.is_err())
+            break;
+        while (received < opts.size)
+        {
+            auto res = co_await tcp.read(buffer);
+            if (res.is_err())
+            {
+                results.errors++;
+                credits.close();
+                in_flight.close();
+                co_await sender.join();
+                co_return;
+            }
+            received += res.unwrap().size();
+            results.bytes += res.unwrap().size();
+        }
+        received -= opts.size;
+        const auto latency = std::chrono::steady_clock::now() - sent_at.unwrap();
+        results.latency.record(static_cast<uint64_t>(std::chrono::nanoseconds(latency).count()));
+        // the response is read completely, the next request may be sent
+        credits.try_push(0).unwrap();
+    }
+    co_await sender.join();
+    co_await tcp.shutdown();
+}
+
+co::func<void> client(const options& opts, load_results& results)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::seconds(opts.duration);
+    std::vector<co::thread> connections;
+    for (size_t i = 0; i < opts.connections; i++)
+        connections.emplace_back(client_connection(opts, deadline, results));
+    for (auto& connection : connections)
+        co_await connection.join();
+    results.elapsed = std::chrono::steady_clock::now() - start;
+}
+
+void print_results(const options& opts, const load_results& results)
+{
+    const double seconds = std::chrono::duration<double>(results.elapsed).count();
+    const auto requests = results.latency.total();
+    std::printf("connections: %zu, message size: %zu bytes, pipeline: %zu, duration: %.2f s\n",
+                opts.connections,
+                opts.size,
+                opts.pipeline,
+                seconds);
+    std::printf("requests: %llu, errors: %llu\n",
+                static_cast<unsigned long long>(requests),
+                static_cast<unsigned long long>(results.errors));
+    std::printf("throughput: %.0f requests/s, %.2f MB/s\n",
+                static_cast<double>(requests) / seconds,
+                static_cast<double>(results.bytes) / seconds / 1e6);
+    std::printf("latency (us):\n");
+    for (double q : { 0.5, 0.9, 0.99, 0.999, 0.9999, 1.0 })
+    {
+        std::printf("  p%-7g %10.1f\n",
+                    q * 100,
+                    static_cast<double>(results.latency.percentile(q)) / 1e3);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    options opts;
+    if (!parse_options(argc, argv, opts))
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--mode=both|server|client] [--host=127.0.0.1] [--port=50008] [--connections=64] [--size=64]"
+                     " [--pipeline=1] [--duration=10]\n";
+        return 1;
+    }
+
+    try
+    {
+        if (opts.mode == "server")
+        {
+            co::loop(
+                [&opts]() -> co::func<void>
+                {
+                    auto server_thread = co::thread(server(opts, nullptr));
+                    auto signal_scoped = co::signal_ctrl_c(server_thread.get_stop_source());
+                    co_await server_thread.join();
+                });
+            return 0;
+        }
+
+        load_results results;
+        if (opts.mode == "client")
+        {
+            co::loop(client(opts, results));
+        }
+        else
+        {
+            // the server and the clients run in separate event loops, so they don't share the CPU time of one loop
+            co::loop_group group(2, /*pin_threads=*/false);
+            co::ts_event listening;
+            co::ts_event done;
+            group
+                .spawn(0,
+                       [&]() -> co::func<void>
+                       {
+                           auto server_thread = co::thread(server(opts, &listening));
+                           co_await done.wait();
+                           server_thread.request_stop();
+                           co_await server_thread.join();
+                       })
+                .detach();
+            group
+                .spawn(1,
+                       [&]() -> co::func<void>
+                       {
+                           co_await listening.wait();
+                           co_await client(opts, results);
+                           done.notify();
+                       })
+                .detach();
+            group.join();
+        }
+        print_results(opts, results);
+        return results.errors == 0 ? 0 : 2;
+    }
+    catch (const co::exception& coexc)
+    {
+        std::cerr << "co_lib error: " << coexc << '\n';
+    }
+    catch (const std::exception& exc)
+    {
+        std::cerr << "unknown error: " << exc.what() << '\n';
+    }
+    return 1;
+}
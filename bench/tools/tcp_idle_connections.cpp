@@ -0,0 +1,310 @@
+// C10K/C100K idle connections benchmark: opens many loopback connections between a co::net::tcp_listener server and
+// co::net::tcp_stream clients, parks both ends of every connection in tcp_stream::read() and reports the resident
+// memory per connection, the accept rate and the event loop iteration time with all the connections open.
+//
+// Usage:
+//     co_lib_tcp_idle_connections [--connections=10000] [--port=50009] [--addresses=0] [--idle=5]
+//
+// The server and the clients run in two event loops of one process, so the memory per connection includes both ends
+// (two uv_tcp_t handles, two co::threads and their coroutine frames). --addresses is the number of loopback addresses
+// (127.0.0.1, 127.0.0.2, ...) the clients connect to, 0 picks enough addresses to not run out of ephemeral ports.
+// --idle is the number of seconds to keep the connections open while the event loops are measured.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <co/co.hpp>
+#include <co/net/net.hpp>
+
+#include "options.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+struct options
+{
+    size_t connections = 10000;
+    uint16_t port = 50009;
+    size_t addresses = 0;
+    size_t idle = 5;
+};
+
+// number of connections which are being established at the same time, keeps the listen backlog from overflowing
+constexpr size_t max_pending_connects = 64;
+// ephemeral ports available for connections to one address
+constexpr size_t connections_per_address = 20000;
+
+bool parse_options(int argc, char** argv, options& opts)
+{
+    const bool parsed = tools::parse_options(argc,
+                                             argv,
+                                             [&opts](std::string_view name, std::string_view value)
+                                             {
+                                                 if (name == "connections")
+                                                     return tools::parse_number(value, opts.connections);
+                                                 if (name == "port")
+                                                     return tools::parse_number(value, opts.port);
+                                                 if (name == "addresses")
+                                                     return tools::parse_number(value, opts.addresses);
+                                                 if (name == "idle")
+                                                     return tools::parse_number(value, opts.idle);
+                                                 return false;
+                                             });
+    if (!parsed)
+        return false;
+    if (opts.addresses == 0)
+        opts.addresses = (opts.connections + connections_per_address - 1) / connections_per_address;
+    return opts.connections > 0 && opts.addresses > 0 && opts.addresses < 255;
+}
+
+/// \brief get the resident memory of the process in bytes, 0 if it's unknown
+size_t resident_memory()
+{
+#if defined(__linux__)
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr)
+        return 0;
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    const int n = std::fscanf(statm, "%lu %lu", &size, &resident);
+    std::fclose(statm);
+    return n == 2 ? resident * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+
+/// \brief raises the limit of open files to the hard limit, each connection takes two file descriptors
+void raise_open_files_limit(size_t needed)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+        return;
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < needed)
+        std::cerr << "warning: the open files limit " << limit.rlim_cur << " is less than " << needed << "\n";
+#else
+    (void)needed;
+#endif
+}
+
+/// \brief the difference of two snapshots of a histogram, the max is taken from the later one
+co::loop_histogram operator-(const co::loop_histogram& after, const co::loop_histogram& before)
+{
+    co::loop_histogram res = after;
+    for (size_t i = 0; i < co::loop_histogram::n_buckets; i++)
+        res.buckets[i] -= before.buckets[i];
+    res.count -= before.count;
+    res.sum -= before.sum;
+    return res;
+}
+
+struct shared_state
+{
+    explicit shared_state(const options& opts)
+        : opts(opts)
+    {}
+
+    const options& opts;
+    co::ts_event listening;
+    // all the connections are accepted by the server
+    co::ts_event accepted_all;
+    // all the connections are connected by the clients
+    co::ts_event established;
+    // the connections can be closed
+    co::ts_event release;
+    std::chrono::steady_clock::duration accept_time{};
+    size_t accepted = 0;
+    // connections failed to connect, they are never accepted
+    std::atomic<size_t> errors = 0;
+};
+
+// waits for the client to close the connection
+co::func<void> serve_client(co::net::tcp_stream tcp)
+{
+    std::array<char, 64> buffer;
+    while ((co_await tcp.read(buffer)).is_ok())
+    {}
+    co_await tcp.shutdown();
+}
+
+// wakes up the event loop every millisecond until the connections are released, so the iteration time is measured
+// with all the connections open
+co::func<void> tick_until_released(shared_state& state)
+{
+    while (!state.release.is_notified())
+        co_await co::this_thread::sleep_for(1ms);
+}
+
+co::func<void> server(shared_state& state)
+{
+    auto listener = co_await co::net::tcp_listener::bind("0.0.0.0", state.opts.port).unwrap();
+    state.listening.notify();
+
+    std::optional<std::chrono::steady_clock::time_point> first_accept;
+    while (state.accepted + state.errors.load() < state.opts.connections)
+    {
+        auto res = co_await listener.accept({ 100ms });
+        if (res == co::timeout)
+            continue;
+        auto stream = std::move(res.unwrap());
+        if (!first_accept)
+            first_accept = std::chrono::steady_clock::now();
+        co::thread(serve_client(std::move(stream))).detach();
+        state.accepted++;
+    }
+    if (first_accept)
+        state.accept_time = std::chrono::steady_clock::now() - *first_accept;
+    state.accepted_all.notify();
+    co_await tick_until_released(state);
+}
+
+co::func<void> client_connection(std::string ip,
+                                 uint16_t port,
+                                 std::optional<co::net::tcp_stream>& stream,
+                                 co::channel<bool> connected)
+{
+    auto res = co_await co::net::tcp_stream::connect(ip, port);
+    if (res.is_err())
+    {
+        co_await connected.push(false);
+        co_return;
+    }
+    stream.emplace(std::move(res.unwrap()));
+    co_await connected.push(true);
+
+    // parks until the server closes its side in response to the shutdown
+    std::array<char, 64> buffer;
+    while ((co_await stream->read(buffer)).is_ok())
+    {}
+}
+
+co::func<void> client(shared_state& state)
+{
+    co_await state.listening.wait();
+
+    const auto& opts = state.opts;
+    std::vector<std::optional<co::net::tcp_stream>> streams(opts.connections);
+    std::vector<co::thread> threads;
+    threads.reserve(opts.connections);
+    co::channel<bool> connected(max_pending_connects);
+    size_t pending = 0;
+    auto wait_connected = [&]() -> co::func<void>
+    {
+        if (!(co_await connected.pop()).unwrap())
+            state.errors++;
+        pending--;
+    };
+
+    for (size_t i = 0; i < opts.connections; i++)
+    {
+        if (pending == max_pending_connects)
+            co_await wait_connected();
+        const auto ip = "127.0.0." + std::to_string(1 + i % opts.addresses);
+        threads.emplace_back(client_connection(ip, opts.port, streams[i], connected));
+        pending++;
+    }
+    while (pending > 0)
+        co_await wait_connected();
+
+    state.established.notify();
+    co_await tick_until_released(state);
+
+    for (auto& stream : streams)
+    {
+        if (stream)
+            co_await stream->shutdown();
+    }
+    for (auto& thread : threads)
+        co_await thread.join();
+}
+
+void print_loop(const char* name, const co::loop_stats& before, const co::loop_stats& after)
+{
+    const auto lag = after.loop_lag - before.loop_lag;
+    std::printf("%s loop: %llu iterations, iteration time (without poll) mean %.1f us, p99 %.1f us, max %.1f us\n",
+                name,
+                static_cast<unsigned long long>(after.iterations - before.iterations),
+                lag.mean() / 1e3,
+                static_cast<double>(lag.percentile(0.99)) / 1e3,
+                static_cast<double>(lag.max) / 1e3);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    options opts;
+    if (!parse_options(argc, argv, opts))
+    {
+        std::cerr << "usage: " << argv[0] << " [--connections=10000] [--port=50009] [--addresses=0] [--idle=5]\n";
+        return 1;
+    }
+    raise_open_files_limit(2 * opts.connections + 64);
+
+    try
+    {
+        shared_state state(opts);
+        co::loop_group group(2, /*pin_threads=*/false);
+        const size_t memory_before = resident_memory();
+        const auto start = std::chrono::steady_clock::now();
+        group.spawn(0, server(state)).detach();
+        group.spawn(1, client(state)).detach();
+
+        state.established.blocking_wait();
+        state.accepted_all.blocking_wait();
+        const auto established_time = std::chrono::steady_clock::now() - start;
+        const size_t memory_after = resident_memory();
+
+        const auto server_before = group.stats(0);
+        const auto client_before = group.stats(1);
+        std::this_thread::sleep_for(std::chrono::seconds(opts.idle));
+        const auto server_after = group.stats(0);
+        const auto client_after = group.stats(1);
+
+        state.release.notify();
+        group.join();
+
+        const auto connections = static_cast<double>(opts.connections);
+        std::printf("connections: %zu over %zu loopback addresses, errors: %zu\n",
+                    opts.connections,
+                    opts.addresses,
+                    state.errors.load());
+        std::printf("established in %.2f s, accept rate: %.0f connections/s\n",
+                    std::chrono::duration<double>(established_time).count(),
+                    connections / std::max(std::chrono::duration<double>(state.accept_time).count(), 1e-9));
+        if (memory_before != 0 && memory_after >= memory_before)
+        {
+            std::printf("resident memory: %.1f MB, %.0f bytes per connection (both ends)\n",
+                        static_cast<double>(memory_after - memory_before) / 1e6,
+                        static_cast<double>(memory_after - memory_before) / connections);
+        }
+        print_loop("server", server_before, server_after);
+        print_loop("client", client_before, client_after);
+        return state.errors == 0 ? 0 : 2;
+    }
+    catch (const co::exception& coexc)
+    {
+        std::cerr << "co_lib error: " << coexc << '\n';
+    }
+    catch (const std::exception& exc)
+    {
+        std::cerr << "unknown error: " << exc.what() << '\n';
+    }
+    return 1;
+}
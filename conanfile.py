@@ -10,9 +10,9 @@ class CoLibConan(ConanFile):
     topics = ("c++20", "coroutines", "asynchronous programming")
     generators = "cmake"
     settings = "os", "compiler", "build_type", "arch"
-    exports_sources = "src/*", "CMakeLists.txt", "tests/*", "cmake/*"
+    exports_sources = "src/*", "CMakeLists.txt", "tests/*", "bench/*", "cmake/*"
     requires = "libuv/1.40.0", "boost/1.75.0"
-    build_requires = "catch2/2.13.4"
+    build_requires = "catch2/2.13.4", "benchmark/1.5.3"
     default_options = {
         "boost:header_only": True,
     }
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <co/channel.hpp>
+#include <co/check.hpp>
+#include <co/impl/waiting_queue.hpp>
+#include <co/status_codes.hpp>
+#include <co/until.hpp>
+
+namespace co::impl
+{
+
+/// \brief the ring shared by the broadcast channel and all its subscribers. A message of sequence number seq is kept in
+/// the slot seq % capacity until it's overwritten by the message seq + capacity
+template <typename T, bool ThreadSafe>
+struct broadcast_shared_state
+{
+    using lock_type = std::conditional_t<ThreadSafe, std::mutex, dummy_mutex>;
+
+    explicit broadcast_shared_state(size_t capacity)
+        : _ring(capacity)
+    {
+        CO_CHECK(capacity > 0) << "broadcast_channel capacity should be greater than 0";
+    }
+
+    /// \brief sequence number of the oldest message in the ring
+    [[nodiscard]] uint64_t oldest() const noexcept
+    {
+        return _tail > _ring.size() ? _tail - _ring.size() : 0;
+    }
+
+    lock_type _mutex;
+    bool _closed = false;
+    std::vector<std::optional<T>> _ring;
+    uint64_t _tail = 0;  // sequence number of the next message
+    // all the subscribers waiting for the next message, a push wakes all of them up
+    waiting_queue_base<ThreadSafe> _subscribers_waiting_queue;
+};
+
+}  // namespace co::impl
+
+namespace co
+{
+
+template <typename T, bool ThreadSafe>
+class broadcast_subscriber;
+
+/// \brief channel which delivers every message to all of its subscribers
+/// \tparam T type of data to be passed, it should be copyable. Use std::shared_ptr<const M> for heavy messages
+///
+/// The messages are stored once in a ring of fixed capacity, every subscriber has its own read cursor in the ring.
+/// push() never waits: a new message overwrites the oldest one even if some subscribers haven't read it yet. Such a
+/// lagging subscriber gets co::lagged and continues from the oldest message still in the ring. One push wakes up all
+/// the parked subscribers in one pass.
+///
+/// broadcast_channel owns a count referenced data inside. Thus it's cheap to copy it.
+/// Usage:
+/// \code
+///     co::broadcast_channel<quote> quotes(1024);
+///     auto sub = quotes.subscribe();
+///     co::thread(
+///         [sub]() mutable -> co::func<void>
+///         {
+///             while (true)
+///             {
+///                 auto res = co_await sub.pop();
+///                 if (res == co::lagged)
+///                     std::cout << "missed " << sub.lagged_by() << " quotes\n";
+///                 else if (res == co::closed)
+///                     break;
+///             }
+///         }).detach();
+///     quotes.push(quote{ "AAPL", 150.0 }).unwrap();
+///     quotes.close();
+/// \endcode
+template <typename T, bool ThreadSafe>
+class broadcast_channel_base
+{
+public:
+    /// \brief create a new broadcast channel keeping the last capacity messages
+    explicit broadcast_channel_base(size_t capacity)
+        : _state(std::make_shared<impl::broadcast_shared_state<T, ThreadSafe>>(capacity))
+    {}
+
+    /// \brief stores a new message for all the subscribers, overwrites the oldest one if the ring is full
+    /// \return ok, co::closed
+    template <typename T2>
+    co::result<void> push(T2&& t) requires(std::is_constructible_v<T, T2>);
+
+    /// \brief creates a subscriber which receives the messages pushed after the subscription
+    broadcast_subscriber<T, ThreadSafe> subscribe();
+
+    /// \brief closes the channel. Subscribers will get co::closed after they have read the remaining messages
+    void close();
+
+    /// \brief returns true if the channel is closed
+    [[nodiscard]] bool is_closed() const;
+
+private:
+    void check_shared_state() const
+    {
+        CO_CHECK(_state != nullptr) << "Propbably you are trying to use the channel after a move.";
+    }
+
+private:
+    std::shared_ptr<impl::broadcast_shared_state<T, ThreadSafe>> _state;
+};
+
+/// \brief read cursor of a broadcast channel. A subscriber is meant to be used by one co::thread, copy it to get an
+/// independent cursor at the same position
+template <typename T, bool ThreadSafe>
+class broadcast_subscriber
+{
+    friend class broadcast_channel_base<T, ThreadSafe>;
+
+public:
+    /// \brief copies the next message or returns co::empty
+    /// \return ok, co::empty, co::lagged, co::closed
+    co::result<T> try_pop();
+
+    /// \brief copies the next message. Blocks until a message comes or is interrupted
+    /// \return ok, co::lagged, co::closed, co::cancel, co::timeout
+    co::func<co::result<T>> pop(co::until until = {});
+
+    /// \brief The blocking version of pop(). It will block the current OS thread until a message comes or the channel
+    /// is closed
+    /// \return ok, co::lagged, co::closed
+    co::result<T> blocking_pop() requires(ThreadSafe);
+
+    /// \brief The blocking version of pop(). It will block the current OS thread until a message comes, the channel is
+    /// closed or timeout has occured
+    /// \return ok, co::lagged, co::closed, co::timeout
+    template <typename Rep, typename Period>
+    co::result<T> blocking_pop(std::chrono::duration<Rep, Period> timeout) requires(ThreadSafe);
+
+    /// \brief number of messages skipped by the last co::lagged result
+    [[nodiscard]] uint64_t lagged_by() const noexcept
+    {
+        return _lagged_by;
+    }
+
+private:
+    broadcast_subscriber(std::shared_ptr<impl::broadcast_shared_state<T, ThreadSafe>> state, uint64_t next)
+        : _state(std::move(state))
+        , _next(next)
+    {}
+
+    void check_shared_state() const
+    {
+        CO_CHECK(_state != nullptr) << "Propbably you are trying to use the subscriber after a move.";
+    }
+
+    /// \brief copies the next message, moves the cursor to the oldest message if it has been overwritten. Must be
+    /// called under the mutex
+    co::result<T> pop_locked();
+
+private:
+    std::shared_ptr<impl::broadcast_shared_state<T, ThreadSafe>> _state;
+    uint64_t _next;  // sequence number of the next message to read
+    uint64_t _lagged_by = 0;
+};
+
+template <typename T, bool ThreadSafe>
+template <typename T2>
+co::result<void> broadcast_channel_base<T, ThreadSafe>::push(T2&& t) requires(std::is_constructible_v<T, T2>)
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    if (_state->_closed)
+        return co::err(co::closed);
+
+    _state->_ring[_state->_tail % _state->_ring.size()].emplace(std::forward<T2>(t));
+    _state->_tail++;
+    _state->_subscribers_waiting_queue.notify_all();
+    return co::ok();
+}
+
+template <typename T, bool ThreadSafe>
+broadcast_subscriber<T, ThreadSafe> broadcast_channel_base<T, ThreadSafe>::subscribe()
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    return { _state, _state->_tail };
+}
+
+template <typename T, bool ThreadSafe>
+void broadcast_channel_base<T, ThreadSafe>::close()
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    _state->_closed = true;
+    _state->_subscribers_waiting_queue.notify_all();
+}
+
+template <typename T, bool ThreadSafe>
+[[nodiscard]] bool broadcast_channel_base<T, ThreadSafe>::is_closed() const
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    return _state->_closed;
+}
+
+template <typename T, bool ThreadSafe>
+co::result<T> broadcast_subscriber<T, ThreadSafe>::pop_locked()
+{
+    const uint64_t oldest = _state->oldest();
+    if (_next < oldest)
+    {
+        _lagged_by = oldest - _next;
+        _next = oldest;
+        return co::err(co::lagged);
+    }
+    if (_next == _state->_tail)
+        return _state->_closed ? co::err(co::closed) : co::err(co::empty);
+
+    const auto& message = _state->_ring[_next % _state->_ring.size()];
+    CO_DCHECK(message.has_value());
+    _next++;
+    return co::ok(T(*message));
+}
+
+template <typename T, bool ThreadSafe>
+co::result<T> broadcast_subscriber<T, ThreadSafe>::try_pop()
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    return pop_locked();
+}
+
+template <typename T, bool ThreadSafe>
+co::func<co::result<T>> broadcast_subscriber<T, ThreadSafe>::pop(co::until until)
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    while (true)
+    {
+        co::result<T> res = pop_locked();
+        if (res != co::empty)
+        {
+            lk.unlock();
+            if (impl::consume_budget())
+                co_await impl::yield_awaiter{};
+            co_return res;
+        }
+
+        auto wait_res = co_await _state->_subscribers_waiting_queue.wait(lk, until);
+        if (wait_res.is_err())
+            co_return wait_res.err();
+    }
+}
+
+template <typename T, bool ThreadSafe>
+co::result<T> broadcast_subscriber<T, ThreadSafe>::blocking_pop() requires(ThreadSafe)
+{
+    return blocking_pop(std::chrono::steady_clock::duration::max());
+}
+
+template <typename T, bool ThreadSafe>
+template <typename Rep, typename Period>
+co::result<T> broadcast_subscriber<T, ThreadSafe>::blocking_pop(std::chrono::duration<Rep, Period> timeout) requires(
+    ThreadSafe)
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    co::result<void> wait_res = co::ok();
+    // the timeout is for the whole call, wakeups which don't bring a result wait for the rest of it
+    const auto deadline = timeout == std::chrono::duration<Rep, Period>::max()
+                              ? std::chrono::steady_clock::time_point::max()
+                              : std::chrono::steady_clock::now() +
+                                    std::chrono::ceil<std::chrono::steady_clock::duration>(timeout);
+    while (true)
+    {
+        // a message pushed right at the timeout is still taken
+        co::result<T> res = pop_locked();
+        if (res != co::empty)
+            return res;
+        if (wait_res.is_err())
+            return wait_res.err();
+
+        if (timeout == std::chrono::duration<Rep, Period>::max())
+            _state->_subscribers_waiting_queue.blocking_wait(lk);
+        else
+            wait_res = _state->_subscribers_waiting_queue.blocking_wait(lk, deadline - std::chrono::steady_clock::now());
+    }
+}
+
+template <typename T>
+using broadcast_channel = broadcast_channel_base<T, /*ThreadSafe=*/false>;
+template <typename T>
+using ts_broadcast_channel = broadcast_channel_base<T, /*ThreadSafe=*/true>;
+
+}  // namespace co
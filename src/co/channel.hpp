@@ -1,14 +1,34 @@
 #pragma once
 
 #include <chrono>
+#include <iterator>
 #include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
 
 #include <boost/circular_buffer.hpp>
 #include <co/check.hpp>
+#include <co/event.hpp>
+#include <co/impl/intrusive_list.hpp>
+#include <co/impl/segmented_queue.hpp>
 #include <co/impl/waiting_queue.hpp>
 #include <co/status_codes.hpp>
 #include <co/until.hpp>
 
+namespace co
+{
+
+/// \brief what push does when the channel is full
+enum class overflow_policy
+{
+    wait,         // push waits for space, try_push returns co::full
+    drop_oldest,  // the oldest value of the buffer is dropped to make room for the new one
+    drop_newest   // the new value is dropped
+};
+
+}  // namespace co
+
 namespace co::impl
 {
 
@@ -18,12 +38,29 @@ struct dummy_mutex
     void unlock(){};
 };
 
+/// \brief a consumer parked on an empty channel. A producer hands the value over right into the slot instead of the
+/// buffer and notifies the consumer's event. The slot lives in the consumer's frame (stack) and is guarded by the
+/// channel's mutex. The event may be shared by the slots of several channels (see co::select), only the first producer
+/// notifies it successfully and hands its value over
 template <typename T, bool ThreadSafe>
+struct handoff_slot
+{
+    std::optional<T> value;
+    event_base<ThreadSafe>* event = nullptr;
+    intrusive_list_hook hook;
+};
+
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+class select_recv;
+
+template <typename T, bool ThreadSafe, typename Queue>
 struct channel_shared_state
 {
 public:
     using lock_type = std::conditional_t<ThreadSafe, std::mutex, dummy_mutex>;
-    using queue_type = boost::circular_buffer<T>;
+    using queue_type = Queue;
+    using slot_type = handoff_slot<T, ThreadSafe>;
+    using parked_consumers_list = intrusive_list<slot_type, &slot_type::hook>;
 
     explicit channel_shared_state(size_t capacity)
         : _queue(capacity)
@@ -32,8 +69,11 @@ public:
     lock_type _mutex;
     bool _closed = false;
     queue_type _queue;
+    size_t _dropped = 0;  // values dropped by the overflow policy
     impl::waiting_queue_base<ThreadSafe> _producer_waiting_queue;
-    impl::waiting_queue_base<ThreadSafe> _consumer_waiting_queue;
+    // consumers park only when the buffer is empty and producers hand values over to them before filling the buffer,
+    // thus the buffer is empty while there are parked consumers
+    parked_consumers_list _parked_consumers;
 };
 
 }  // namespace co::impl
@@ -44,6 +84,14 @@ namespace co
 /// \brief buffered channel to pass data of type T between co::threads
 /// \tparam T type of data to be passed
 ///
+/// A value pushed while a consumer is parked in pop() is handed over to the consumer directly, it doesn't go through
+/// the buffer. A channel with zero capacity is a rendezvous channel: it has no buffer, push() waits until a consumer
+/// takes the value, try_push() succeeds only if a consumer is parked and try_pop() never finds a value.
+///
+/// With a dropping overflow policy the channel never makes producers wait: push() and try_push() succeed while the
+/// channel is open, the values which don't fit are dropped and counted by dropped(). A dropping rendezvous channel
+/// drops every value nobody is waiting for.
+///
 /// channel owns a count referenced data inside. Thus it's cheap to copy a channel.
 /// Usage:
 /// \code
@@ -68,13 +116,23 @@ namespace co
 ///     }
 ///     co_await th1.join();
 /// \endcode
-template <typename T, bool ThreadSafe>
+template <typename T,
+          bool ThreadSafe,
+          typename Queue = boost::circular_buffer<T>,
+          overflow_policy Overflow = overflow_policy::wait>
 class channel_base
 {
+    friend class impl::select_recv<T, ThreadSafe, Queue, Overflow>;
+
 public:
-    /// \brief create a new channel with capacity
+    /// \brief create a new channel with capacity, 0 creates a rendezvous channel
     explicit channel_base(size_t capacity)
-        : _state(std::make_shared<impl::channel_shared_state<T, ThreadSafe>>(capacity))
+        : _state(std::make_shared<impl::channel_shared_state<T, ThreadSafe, Queue>>(capacity))
+    {}
+
+    /// \brief create a new unbounded channel without a limit
+    channel_base() requires(std::is_same_v<Queue, impl::segmented_queue<T>>)
+        : channel_base(Queue::no_limit)
     {}
 
     /// \brief pushes a new value to the channel. Returns co::full if the channel is full
@@ -98,14 +156,34 @@ public:
                                    std::chrono::duration<Rep, Period> timeout) requires(ThreadSafe ||
                                                                                         std::is_constructible_v<T, T2>);
 
+    /// \brief pushes all the values of the range to the channel. Blocks while the channel is full until it has space
+    /// or is interrupted. The values are pushed under one lock as long as they fit: parked consumers get a value each,
+    /// the rest goes to the buffer without waking anybody up. The values are copied, pass a range of move iterators to
+    /// move them
+    /// \return the number of pushed values. It's less than the range size if the channel is closed or the wait is
+    /// interrupted after some values have been pushed. co::close, co::cancel, co::timeout if nothing has been pushed
+    template <std::ranges::input_range R>
+    co::func<co::result<size_t>> push_many(R&& range, co::until until = {}) requires(
+        std::is_constructible_v<T, std::ranges::range_reference_t<R>>);
+
     /// \brief pop the front value from the channel or returns co::empty
     /// \return ok, co::empty, co::close
     co::result<T> try_pop();
 
+    /// \brief pops up to out.size() front values from the channel under one lock and moves them to out
+    /// \return the number of popped values, co::empty, co::close
+    co::result<size_t> try_pop_many(std::span<T> out);
+
     /// \brief pop the front value from the channel. Blocks until the channel has some values or is interrupted
     /// \return ok, co::close, co::cancel, co::timeout
     co::func<co::result<T>> pop(co::until until = {});
 
+    /// \brief pops up to max front values from the channel under one lock and writes them to out. Blocks until the
+    /// channel has some values or is interrupted, doesn't wait for max values to come
+    /// \return the number of popped values, co::close, co::cancel, co::timeout
+    template <std::output_iterator<T> OutputIt>
+    co::func<co::result<size_t>> pop_many(OutputIt out, size_t max, co::until until = {});
+
     /// \brief The blocking version of pop(). It will block the current OS thread until the channel has value or be
     /// closed. \return ok, co::close
     co::result<T> blocking_pop() requires(ThreadSafe);
@@ -122,80 +200,211 @@ public:
     /// \brief returns true if the channel is closed
     [[nodiscard]] bool is_closed() const;
 
+    /// \brief returns the number of values dropped by the overflow policy
+    [[nodiscard]] size_t dropped() const requires(Overflow != overflow_policy::wait);
+
 private:
+    using slot_type = impl::handoff_slot<T, ThreadSafe>;
+
     void check_shared_state() const
     {
         CO_CHECK(_state != nullptr)
                 << "Propbably you are trying to use the channel after a move.";
     }
 
+    /// \brief hands the value over to a parked consumer or puts it to the buffer. Must be called under the mutex.
+    /// Returns false if there is neither a parked consumer nor space in the buffer, t is left untouched then. A dropping
+    /// overflow policy drops a value instead and always returns true
+    template <typename T2>
+    bool push_locked(T2&& t);
+
+    /// \brief pops the front value of the buffer and wakes up a producer. Must be called under the mutex
+    T pop_front_locked();
+
+    /// \brief parks the consumer while the buffer is empty, a producer will notify the event. Must be called under the
+    /// mutex
+    void park_consumer_locked(slot_type& slot, event_base<ThreadSafe>& event);
+
+    /// \brief unparks the consumer after the wakeup. Must be called under the mutex
+    void unpark_consumer_locked(slot_type& slot);
+
 private:
-    std::shared_ptr<impl::channel_shared_state<T, ThreadSafe>> _state;
+    std::shared_ptr<impl::channel_shared_state<T, ThreadSafe, Queue>> _state;
 };
 
-template <typename T, bool ThreadSafe>
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+template <typename T2>
+bool channel_base<T, ThreadSafe, Queue, Overflow>::push_locked(T2&& t)
+{
+    auto& parked_consumers = _state->_parked_consumers;
+    while (!parked_consumers.empty())
+    {
+        slot_type& slot = parked_consumers.front();
+        parked_consumers.pop_front();
+        // the consumer reacquires the mutex before it looks into the slot, so the value can be put after the wakeup.
+        // The wakeup fails if the consumer has been interrupted, try the next one then
+        if (slot.event->notify())
+        {
+            slot.value.emplace(std::forward<T2>(t));
+            return true;
+        }
+    }
+
+    if (!_state->_queue.full())
+    {
+        _state->_queue.push_back(std::forward<T2>(t));
+        return true;
+    }
+
+    if constexpr (Overflow == overflow_policy::wait)
+    {
+        return false;
+    }
+    else
+    {
+        _state->_dropped++;
+        if constexpr (Overflow == overflow_policy::drop_oldest)
+        {
+            // a rendezvous channel has no oldest value, the new one is dropped then
+            if (!_state->_queue.empty())
+            {
+                _state->_queue.pop_front();
+                _state->_queue.push_back(std::forward<T2>(t));
+            }
+        }
+        return true;
+    }
+}
+
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+T channel_base<T, ThreadSafe, Queue, Overflow>::pop_front_locked()
+{
+    CO_DCHECK(!_state->_queue.empty());
+    T value = std::move(_state->_queue.front());
+    _state->_queue.pop_front();
+    _state->_producer_waiting_queue.notify_one();
+    return value;
+}
+
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+void channel_base<T, ThreadSafe, Queue, Overflow>::park_consumer_locked(slot_type& slot, event_base<ThreadSafe>& event)
+{
+    CO_DCHECK(_state->_queue.empty());
+    slot.event = &event;
+    _state->_parked_consumers.push_back(slot);
+    // producers of a rendezvous channel wait for a consumer to come
+    _state->_producer_waiting_queue.notify_one();
+}
+
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+void channel_base<T, ThreadSafe, Queue, Overflow>::unpark_consumer_locked(slot_type& slot)
+{
+    // the slot is unlinked by the producer which has notified it
+    if (slot.hook.is_linked())
+        slot.hook.unlink();
+}
+
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
 template <typename T2>
-co::result<void> channel_base<T, ThreadSafe>::try_push(T2&& t) requires(std::is_constructible_v<T, T2>)
+co::result<void> channel_base<T, ThreadSafe, Queue, Overflow>::try_push(T2&& t) requires(std::is_constructible_v<T, T2>)
 {
     check_shared_state();
     std::unique_lock lk(_state->_mutex);
     if (_state->_closed)
         return co::err(co::closed);
 
-    if (_state->_queue.full())
+    if (!push_locked(std::forward<T2>(t)))
         return co::err(co::full);
-
-    _state->_queue.push_back(std::forward<T2>(t));
-    _state->_consumer_waiting_queue.notify_one();
     return co::ok();
 }
 
-template <typename T, bool ThreadSafe>
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
 template <typename T2>
-co::func<co::result<void>> channel_base<T, ThreadSafe>::push(T2&& t,
+co::func<co::result<void>> channel_base<T, ThreadSafe, Queue, Overflow>::push(T2&& t,
                                                              co::until until) requires(std::is_constructible_v<T, T2>)
 {
     check_shared_state();
     std::unique_lock lk(_state->_mutex);
-    if (_state->_closed)
-        co_return co::err(co::closed);
+    while (true)
+    {
+        if (_state->_closed)
+            co_return co::err(co::closed);
+        if (push_locked(std::forward<T2>(t)))
+            break;
+        auto res = co_await _state->_producer_waiting_queue.wait(lk, until);
+        if (res.is_err())
+            co_return res.err();
+    }
 
-    while (_state->_queue.full() && !_state->_closed)
+    // pop_many wakes up one producer per batch, pass the wakeup on if there is still space
+    if (!_state->_queue.full())
+        _state->_producer_waiting_queue.notify_one();
+    lk.unlock();
+    if (impl::consume_budget())
+        co_await impl::yield_awaiter{};
+    co_return co::ok();
+}
+
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+template <std::ranges::input_range R>
+co::func<co::result<size_t>> channel_base<T, ThreadSafe, Queue, Overflow>::push_many(R&& range, co::until until) requires(
+    std::is_constructible_v<T, std::ranges::range_reference_t<R>>)
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    size_t n_pushed = 0;
+    auto it = std::ranges::begin(range);
+    const auto end = std::ranges::end(range);
+    while (it != end && !_state->_closed)
     {
+        if (push_locked(*it))
+        {
+            ++it;
+            n_pushed++;
+            continue;
+        }
+
         auto res = co_await _state->_producer_waiting_queue.wait(lk, until);
         if (res.is_err())
+        {
+            if (n_pushed > 0)
+                co_return co::ok(n_pushed);
             co_return res.err();
+        }
     }
 
-    if (_state->_closed)
+    if (n_pushed == 0 && _state->_closed)
         co_return co::err(co::closed);
-
-    CO_DCHECK(!_state->_queue.full());
-    _state->_queue.push_back(std::forward<T2>(t));
-    _state->_consumer_waiting_queue.notify_one();
-    co_return co::ok();
+    if (!_state->_queue.full())
+        _state->_producer_waiting_queue.notify_one();
+    lk.unlock();
+    if (impl::consume_budget())
+        co_await impl::yield_awaiter{};
+    co_return co::ok(n_pushed);
 }
 
-template <typename T, bool ThreadSafe>
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
 template <typename T2>
-co::result<void> channel_base<T, ThreadSafe>::blocking_push(T2&& t) requires(ThreadSafe ||
+co::result<void> channel_base<T, ThreadSafe, Queue, Overflow>::blocking_push(T2&& t) requires(ThreadSafe ||
                                                                              std::is_constructible_v<T, T2>)
 {
     return blocking_push(std::forward<T2>(t), std::chrono::steady_clock::duration::max());
 }
 
-template <typename T, bool ThreadSafe>
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
 template <typename T2, typename Rep, typename Period>
-co::result<void> channel_base<T, ThreadSafe>::blocking_push(
+co::result<void> channel_base<T, ThreadSafe, Queue, Overflow>::blocking_push(
     T2&& t, std::chrono::duration<Rep, Period> timeout) requires(ThreadSafe || std::is_constructible_v<T, T2>)
 {
     check_shared_state();
     std::unique_lock lk(_state->_mutex);
-    if (_state->_closed)
-        return co::err(co::closed);
-
-    while (_state->_queue.full() && !_state->_closed)
+    while (true)
     {
+        if (_state->_closed)
+            return co::err(co::closed);
+        if (push_locked(std::forward<T2>(t)))
+            break;
+
         // `blocking_wait` will reacquire the lock
         // TODO: timeout should be a global one, currently it is for every blocking_wait call here.
         co::result<void> res = co::ok();
@@ -211,17 +420,27 @@ co::result<void> channel_base<T, ThreadSafe>::blocking_push(
             return res.err();
     }
 
-    if (_state->_closed)
+    if (!_state->_queue.full())
+        _state->_producer_waiting_queue.notify_one();
+    return co::ok();
+}
+
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+co::result<T> channel_base<T, ThreadSafe, Queue, Overflow>::try_pop()
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    if (_state->_closed && _state->_queue.empty())
         return co::err(co::closed);
 
-    CO_DCHECK(!_state->_queue.full());
-    _state->_queue.push_back(std::forward<T2>(t));
-    _state->_consumer_waiting_queue.notify_one();
-    return co::ok();
+    if (_state->_queue.empty())
+        return co::err(co::empty);
+
+    return co::ok(pop_front_locked());
 }
 
-template <typename T, bool ThreadSafe>
-co::result<T> channel_base<T, ThreadSafe>::try_pop()
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+co::result<size_t> channel_base<T, ThreadSafe, Queue, Overflow>::try_pop_many(std::span<T> out)
 {
     check_shared_state();
     std::unique_lock lk(_state->_mutex);
@@ -231,100 +450,196 @@ co::result<T> channel_base<T, ThreadSafe>::try_pop()
     if (_state->_queue.empty())
         return co::err(co::empty);
 
-    result<T> res = co::ok(std::move(_state->_queue.front()));
-    _state->_queue.pop_front();
-    _state->_producer_waiting_queue.notify_one();
-    return res;
+    size_t n_popped = 0;
+    for (; n_popped < out.size() && !_state->_queue.empty(); n_popped++)
+    {
+        out[n_popped] = std::move(_state->_queue.front());
+        _state->_queue.pop_front();
+    }
+    // one wakeup per batch, the woken producer passes it on while there is space left
+    if (n_popped > 0)
+        _state->_producer_waiting_queue.notify_one();
+    return co::ok(n_popped);
 }
 
-template <typename T, bool ThreadSafe>
-co::func<co::result<T>> channel_base<T, ThreadSafe>::pop(co::until until)
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+co::func<co::result<T>> channel_base<T, ThreadSafe, Queue, Overflow>::pop(co::until until)
 {
     check_shared_state();
     std::unique_lock lk(_state->_mutex);
     while (_state->_queue.empty() && !_state->_closed)
     {
-        auto res = co_await _state->_consumer_waiting_queue.wait(lk, until);
-        if (res.is_err())
+        slot_type slot;
+        event_base<ThreadSafe> wakeup;
+        park_consumer_locked(slot, wakeup);
+        lk.unlock();
+        auto res = co_await wakeup.wait(until);
+        lk.lock();
+        unpark_consumer_locked(slot);
+        if (slot.value)
         {
-            // need to notify other consumer to wake up and try to get ready items
-            _state->_consumer_waiting_queue.notify_one();
-            co_return res.err();
+            lk.unlock();
+            result<T> handed_over = co::ok(std::move(*slot.value));
+            if (impl::consume_budget())
+                co_await impl::yield_awaiter{};
+            co_return handed_over;
         }
+        if (res.is_err())
+            co_return res.err();
     }
 
     if (_state->_closed && _state->_queue.empty())
         co_return co::err(co::closed);
 
-    CO_DCHECK(!_state->_queue.empty());
-    result<T> res = co::ok(std::move(_state->_queue.front()));
-    _state->_queue.pop_front();
-    _state->_producer_waiting_queue.notify_one();
+    result<T> res = co::ok(pop_front_locked());
+    lk.unlock();
+    if (impl::consume_budget())
+        co_await impl::yield_awaiter{};
     co_return res;
 }
 
-template <typename T, bool ThreadSafe>
-co::result<T> channel_base<T, ThreadSafe>::blocking_pop() requires(ThreadSafe)
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+template <std::output_iterator<T> OutputIt>
+co::func<co::result<size_t>> channel_base<T, ThreadSafe, Queue, Overflow>::pop_many(OutputIt out, size_t max, co::until until)
+{
+    check_shared_state();
+    if (max == 0)
+        co_return co::ok(size_t(0));
+
+    std::unique_lock lk(_state->_mutex);
+    size_t n_popped = 0;
+    while (_state->_queue.empty() && !_state->_closed)
+    {
+        slot_type slot;
+        event_base<ThreadSafe> wakeup;
+        park_consumer_locked(slot, wakeup);
+        lk.unlock();
+        auto res = co_await wakeup.wait(until);
+        lk.lock();
+        unpark_consumer_locked(slot);
+        if (slot.value)
+        {
+            // the buffer is empty while the consumer is parked, so there is nothing to add to the handed over value
+            *out = std::move(*slot.value);
+            n_popped = 1;
+            break;
+        }
+        if (res.is_err())
+            co_return res.err();
+    }
+
+    if (n_popped == 0)
+    {
+        if (_state->_closed && _state->_queue.empty())
+            co_return co::err(co::closed);
+
+        for (; n_popped < max && !_state->_queue.empty(); n_popped++)
+        {
+            *out = std::move(_state->_queue.front());
+            ++out;
+            _state->_queue.pop_front();
+        }
+        // one wakeup per batch, the woken producer passes it on while there is space left
+        _state->_producer_waiting_queue.notify_one();
+    }
+    lk.unlock();
+    if (impl::consume_budget())
+        co_await impl::yield_awaiter{};
+    co_return co::ok(n_popped);
+}
+
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+co::result<T> channel_base<T, ThreadSafe, Queue, Overflow>::blocking_pop() requires(ThreadSafe)
 {
     return blocking_pop(std::chrono::steady_clock::duration::max());
 }
 
-template <typename T, bool ThreadSafe>
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
 template <typename Rep, typename Period>
-co::result<T> channel_base<T, ThreadSafe>::blocking_pop(std::chrono::duration<Rep, Period> timeout) requires(ThreadSafe)
+co::result<T> channel_base<T, ThreadSafe, Queue, Overflow>::blocking_pop(std::chrono::duration<Rep, Period> timeout) requires(ThreadSafe)
 {
     check_shared_state();
     std::unique_lock lk(_state->_mutex);
     while (_state->_queue.empty() && !_state->_closed)
     {
+        slot_type slot;
+        event_base<ThreadSafe> wakeup;
+        park_consumer_locked(slot, wakeup);
+        lk.unlock();
         co::result<void> res = co::ok();
         if (timeout == std::chrono::duration<Rep, Period>::max())
         {
-            _state->_consumer_waiting_queue.blocking_wait(lk);
+            wakeup.blocking_wait();
         }
         else
         {
-            res = _state->_consumer_waiting_queue.blocking_wait(lk, timeout);
+            res = wakeup.blocking_wait(timeout);
         }
+        lk.lock();
+        unpark_consumer_locked(slot);
+        if (slot.value)
+            return co::ok(std::move(*slot.value));
         if (res.is_err())
-        {
-            // need to notify other consumer to wake up and try to get ready items
-            _state->_consumer_waiting_queue.notify_one();
             return res.err();
-        }
     }
 
     if (_state->_closed && _state->_queue.empty())
         return co::err(co::closed);
 
-    CO_DCHECK(!_state->_queue.empty());
-    result<T> res = co::ok(std::move(_state->_queue.front()));
-    _state->_queue.pop_front();
-    _state->_producer_waiting_queue.notify_one();
-    return res;
+    return co::ok(pop_front_locked());
 }
 
-template <typename T, bool ThreadSafe>
-void channel_base<T, ThreadSafe>::close()
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+void channel_base<T, ThreadSafe, Queue, Overflow>::close()
 {
     check_shared_state();
     std::unique_lock lk(_state->_mutex);
     _state->_closed = true;
     _state->_producer_waiting_queue.notify_all();
-    _state->_consumer_waiting_queue.notify_all();
+    auto& parked_consumers = _state->_parked_consumers;
+    while (!parked_consumers.empty())
+    {
+        slot_type& slot = parked_consumers.front();
+        parked_consumers.pop_front();
+        slot.event->notify();
+    }
 }
 
-template <typename T, bool ThreadSafe>
-[[nodiscard]] bool channel_base<T, ThreadSafe>::is_closed() const
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+[[nodiscard]] bool channel_base<T, ThreadSafe, Queue, Overflow>::is_closed() const
 {
     check_shared_state();
     std::unique_lock lk(_state->_mutex);
     return _state->_closed;
 }
 
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+[[nodiscard]] size_t channel_base<T, ThreadSafe, Queue, Overflow>::dropped() const requires(Overflow !=
+                                                                                          overflow_policy::wait)
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    return _state->_dropped;
+}
+
 template <typename T>
 using channel = channel_base<T, /*ThreadSafe=*/false>;
 template <typename T>
 using ts_channel = channel_base<T, /*ThreadSafe=*/true>;
 
+/// \brief channel without a preallocated buffer, the values are kept in linked segments which are allocated when the
+/// values come and released when they are drained. The channel keeps a couple of released segments for reuse, so an
+/// idle channel takes at most these spare segments. The constructor's capacity is a soft limit: producers wait while the channel holds that many
+/// values, no memory is reserved for them. The default constructor creates a channel without a limit.
+template <typename T>
+using unbounded_channel = channel_base<T, /*ThreadSafe=*/false, impl::segmented_queue<T>>;
+template <typename T>
+using ts_unbounded_channel = channel_base<T, /*ThreadSafe=*/true, impl::segmented_queue<T>>;
+
+/// \brief channel which drops values instead of waiting for space, see overflow_policy. Producers never wait on it
+template <typename T, overflow_policy Overflow>
+using lossy_channel = channel_base<T, /*ThreadSafe=*/false, boost::circular_buffer<T>, Overflow>;
+template <typename T, overflow_policy Overflow>
+using ts_lossy_channel = channel_base<T, /*ThreadSafe=*/true, boost::circular_buffer<T>, Overflow>;
+
 }  // namespace co
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <co/broadcast_channel.hpp>
 #include <co/channel.hpp>
 #include <co/check.hpp>
 #include <co/condition_variable.hpp>
@@ -7,8 +8,16 @@
 #include <co/func.hpp>
 #include <co/future.hpp>
 #include <co/loop.hpp>
+#include <co/loop_clock.hpp>
+#include <co/loop_group.hpp>
+#include <co/loop_stats.hpp>
+#include <co/mpmc_channel.hpp>
 #include <co/mutex.hpp>
+#include <co/priority.hpp>
 #include <co/result.hpp>
+#include <co/select.hpp>
 #include <co/signal_callback.hpp>
+#include <co/spsc_channel.hpp>
 #include <co/this_thread.hpp>
 #include <co/thread.hpp>
+#include <co/watch.hpp>
@@ -35,12 +35,18 @@ public:
     /// \brief unconditionally waits until the condition variable is notified
     ///
     /// notification should be called after wait
-    co::func<void> wait();
+    impl::waiting_queue_awaiter<false, impl::no_lock, false> wait()
+    {
+        return _waiting_queue.wait();
+    }
 
     /// \brief waits until the condition variable is notified or the operation is interrupted
     ///
     /// notification should be called after wait
-    co::func<co::result<void>> wait(const co::until& until);
+    impl::waiting_queue_awaiter<false, impl::no_lock, true> wait(const co::until& until)
+    {
+        return _waiting_queue.wait(until);
+    }
 
     /// \brief waits until the condition variable is notified and predicate is satisfied
     ///
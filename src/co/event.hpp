@@ -3,9 +3,11 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <thread>
 
 #include <co/check.hpp>
 #include <co/impl/thread_storage.hpp>
+#include <co/impl/timer.hpp>
 #include <co/result.hpp>
 #include <co/status_code.hpp>
 #include <co/std.hpp>
@@ -47,7 +49,8 @@ enum class waker_type
 {
     not_set,
     std_thread,
-    co_thread
+    co_thread,
+    event_link  // the notification is forwarded to another event, see event_link
 };
 
 struct std_thread_event_data
@@ -57,6 +60,42 @@ struct std_thread_event_data
     bool _notified = false;
 };
 
+/// \brief forwards the notification of a source event to a target event, thus one waiter can wait for several events.
+/// The link takes the waiter's place in the source event, so the source can't be waited by anybody else meanwhile
+template <bool ThreadSafe>
+class event_link
+{
+    friend class event_base<ThreadSafe>;
+
+public:
+    explicit event_link(event_base<ThreadSafe>& target)
+        : _target(target)
+    {}
+
+    event_link(const event_link&) = delete;
+    event_link& operator=(const event_link&) = delete;
+
+    ~event_link()
+    {
+        CO_DCHECK(_source == nullptr);
+    }
+
+    /// \brief links the source event to the target. Returns false if the source is already notified or interrupted,
+    /// nothing is linked then
+    bool attach(event_base<ThreadSafe>& source) noexcept;
+
+    /// \brief unlinks the source event, it's back to the init state unless it has been notified. Returns when the
+    /// notification of the source (if any) has been forwarded, thus the target can be destroyed afterwards
+    void detach() noexcept;
+
+private:
+    void forward() noexcept;
+
+    event_base<ThreadSafe>& _target;
+    event_base<ThreadSafe>* _source = nullptr;
+    std::atomic<bool> _forwarded = false;
+};
+
 template <bool ThreadSafe>
 class event_awaiter
 {
@@ -74,13 +113,23 @@ public:
     event_awaiter(event_awaiter&&) = delete;
     event_awaiter(const event_awaiter&) = delete;
 
-    bool await_ready() const noexcept
+    bool await_ready() noexcept
     {
-        return _event._status.load(std::memory_order_relaxed) == event_status::ok;
+        if (_event._status.load(std::memory_order_relaxed) != event_status::ok)
+            return false;
+        _yield = consume_budget();
+        return !_yield;
     }
 
     bool await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept
     {
+        if (_yield)
+        {
+            // the event is already notified, but the co::thread has exhausted its budget
+            yield_thread(_thread_storage, awaiting_coroutine);
+            return true;
+        }
+
         // transition init -> waiting
         current_thread_on_suspend(awaiting_coroutine);
         _event._waker_data = static_cast<void*>(_thread_storage);
@@ -123,24 +172,25 @@ public:
 private:
     thread_storage* _thread_storage = nullptr;  // the co::thread to which the awaiter belongs
     event_base<ThreadSafe>& _event;
+    bool _yield = false;
 };
 
 template <bool ThreadSafe>
 class interruptible_event_awaiter
 {
     interruptible_event_awaiter(event_base<ThreadSafe>& event,
-                                std::optional<int64_t> milliseconds_opt,
+                                std::optional<std::chrono::nanoseconds> timeout_opt,
                                 const std::optional<co::stop_token>& token_opt)
         : _thread_storage(get_this_thread_storage_ptr())
         , _event(event)
-        , _milliseconds_opt(std::move(milliseconds_opt))
+        , _timeout_opt(std::move(timeout_opt))
     {
         CO_CHECK(_thread_storage != nullptr) << "The async code can't be run outside of co::loop";
         CO_DCHECK(_event._waker_type == waker_type::not_set);
         CO_DCHECK(_event._status.load(std::memory_order::relaxed) != event_status::waiting);
 
         // Process timeout earlier
-        if (_milliseconds_opt.has_value() && _milliseconds_opt.value() <= 0)
+        if (_timeout_opt.has_value() && _timeout_opt.value().count() <= 0)
         {
             _event.advance_status(event_status::init, event_status::timeout);
         }
@@ -151,7 +201,7 @@ class interruptible_event_awaiter
 
 public:
     interruptible_event_awaiter(event_base<ThreadSafe>& event, const co::until& until)
-        : interruptible_event_awaiter(event, until.milliseconds(), until.token())
+        : interruptible_event_awaiter(event, until.nanoseconds(), until.token())
     {}
 
     interruptible_event_awaiter& operator=(const interruptible_event_awaiter&) = delete;
@@ -159,15 +209,25 @@ public:
     interruptible_event_awaiter(interruptible_event_awaiter&&) = delete;
     interruptible_event_awaiter(const interruptible_event_awaiter&) = delete;
 
-    bool await_ready() const noexcept
+    bool await_ready() noexcept
     {
-        return _event._status.load(std::memory_order_relaxed) > event_status::waiting;
+        if (_event._status.load(std::memory_order_relaxed) <= event_status::waiting)
+            return false;
+        _yield = consume_budget();
+        return !_yield;
     }
 
     bool await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept
     {
         CO_DCHECK(_event._status.load(std::memory_order_relaxed) != event_status::waiting);
 
+        if (_yield)
+        {
+            // the event is already finished, but the co::thread has exhausted its budget
+            yield_thread(_thread_storage, awaiting_coroutine);
+            return true;
+        }
+
         // transition init -> waiting
         current_thread_on_suspend(awaiting_coroutine);
         _event._waker_data = static_cast<void*>(_thread_storage);
@@ -175,8 +235,8 @@ public:
 
         if (_event.advance_status(event_status::init, event_status::waiting))
         {
-            if (_milliseconds_opt.has_value())
-                _thread_storage->_timer.set_timer(_milliseconds_opt.value(), on_timer, static_cast<void*>(this));
+            if (_timeout_opt.has_value())
+                _timer.set_timer(_timeout_opt.value(), on_timer, static_cast<void*>(this));
             return true;
         }
 
@@ -190,8 +250,8 @@ public:
 
         current_thread_on_resume(_thread_storage);
 
-        if (_milliseconds_opt.has_value())
-            _thread_storage->_timer.stop();  // do not wait the timer anymore
+        if (_timeout_opt.has_value())
+            _timer.stop();  // do not wait the timer anymore
 
         switch (status)
         {
@@ -251,8 +311,10 @@ private:
 
     thread_storage* _thread_storage = nullptr;  // the thread to which the awaiter belongs
     event_base<ThreadSafe>& _event;
-    const std::optional<int64_t> _milliseconds_opt;
+    const std::optional<std::chrono::nanoseconds> _timeout_opt;
     std::optional<co::stop_callback> _stop_callback;
+    timer _timer;
+    bool _yield = false;
 };
 
 }  // namespace impl
@@ -262,6 +324,7 @@ class event_base
 {
     friend class impl::event_awaiter<ThreadSafe>;
     friend class impl::interruptible_event_awaiter<ThreadSafe>;
+    friend class impl::event_link<ThreadSafe>;
 
     // TODO: Event can't be moved because timer use a pointer to this.
 
@@ -375,6 +438,10 @@ bool event_base<ThreadSafe>::notify() noexcept
             data->_cv.notify_one();
             break;
         }
+        case impl::waker_type::event_link: {
+            static_cast<impl::event_link<ThreadSafe>*>(_waker_data)->forward();
+            break;
+        }
         default: {
             CO_DCHECK(false);
         }
@@ -386,6 +453,58 @@ bool event_base<ThreadSafe>::notify() noexcept
     return false;
 }
 
+namespace impl
+{
+
+template <bool ThreadSafe>
+bool event_link<ThreadSafe>::attach(event_base<ThreadSafe>& source) noexcept
+{
+    CO_DCHECK(_source == nullptr);
+    CO_CHECK(source._status.load(std::memory_order_relaxed) != event_status::waiting)
+        << "Event has been already waited.";
+
+    _forwarded.store(false, std::memory_order_relaxed);
+    source._waker_data = static_cast<void*>(this);
+    source._waker_type = waker_type::event_link;
+    if (!source.advance_status(event_status::init, event_status::waiting))
+    {
+        source._waker_data = nullptr;
+        source._waker_type = waker_type::not_set;
+        return false;
+    }
+    _source = &source;
+    return true;
+}
+
+template <bool ThreadSafe>
+void event_link<ThreadSafe>::detach() noexcept
+{
+    CO_DCHECK(_source != nullptr);
+    if (_source->advance_status(event_status::waiting, event_status::init))
+    {
+        // nobody has notified the source, it can be waited again
+        _source->_waker_data = nullptr;
+        _source->_waker_type = waker_type::not_set;
+    }
+    else
+    {
+        // the source has been notified, the notifier may be still forwarding it to the target
+        while (!_forwarded.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+    _source = nullptr;
+}
+
+template <bool ThreadSafe>
+void event_link<ThreadSafe>::forward() noexcept
+{
+    _target.notify();
+    // the link may be destroyed right after the store
+    _forwarded.store(true, std::memory_order_release);
+}
+
+}  // namespace impl
+
 template <bool ThreadSafe>
 void event_base<ThreadSafe>::blocking_wait() requires(ThreadSafe)
 {
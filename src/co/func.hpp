@@ -2,6 +2,7 @@
 
 #include <type_traits>
 #include <co/check.hpp>
+#include <co/impl/frame_allocator.hpp>
 #include <co/impl/shared_state.hpp>
 #include <co/result.hpp>
 #include <co/std.hpp>
@@ -87,6 +88,17 @@ class func_promise_base
 public:
     using type = T;
 
+    // coroutine frames are recycled by the frame allocator of the current OS thread
+    static void* operator new(size_t size)
+    {
+        return get_frame_allocator().allocate(size);
+    }
+
+    static void operator delete(void* ptr, size_t size) noexcept
+    {
+        get_frame_allocator().deallocate(ptr, size);
+    }
+
     std::suspend_always initial_suspend() noexcept
     {
         return {};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+namespace co::impl
+{
+
+// data written by different threads is kept in separate cache lines, so they don't invalidate each other
+inline constexpr size_t cache_line_size = 64;
+
+}  // namespace co::impl
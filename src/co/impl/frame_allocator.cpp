@@ -0,0 +1,94 @@
+#include <co/impl/frame_allocator.hpp>
+
+#include <new>
+#include <co/check.hpp>
+
+namespace co::impl
+{
+
+void* frame_allocator::allocate(size_t size)
+{
+    _stats.allocations++;
+    if (size > max_pooled_size || size == 0)
+    {
+        _stats.large_allocations++;
+        return ::operator new(size);
+    }
+
+    const size_t cls = size_class(size);
+    free_block* block = _free_lists[cls];
+    if (block != nullptr)
+    {
+        _free_lists[cls] = block->next;
+        _free_lists_size[cls]--;
+        _stats.cached_bytes -= (cls + 1) * granularity;
+        _stats.reused++;
+        return static_cast<void*>(block);
+    }
+    return ::operator new((cls + 1) * granularity);
+}
+
+void frame_allocator::deallocate(void* ptr, size_t size) noexcept
+{
+    CO_DCHECK(ptr != nullptr);
+    _stats.deallocations++;
+    if (size > max_pooled_size || size == 0)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    const size_t cls = size_class(size);
+    if (_disabled || _free_lists_size[cls] >= max_cached_per_class)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    auto* block = static_cast<free_block*>(ptr);
+    block->next = _free_lists[cls];
+    _free_lists[cls] = block;
+    _free_lists_size[cls]++;
+    _stats.cached_bytes += (cls + 1) * granularity;
+}
+
+void frame_allocator::release(bool disable) noexcept
+{
+    for (size_t cls = 0; cls < n_size_classes; cls++)
+    {
+        while (_free_lists[cls] != nullptr)
+        {
+            free_block* block = _free_lists[cls];
+            _free_lists[cls] = block->next;
+            ::operator delete(static_cast<void*>(block));
+        }
+        _free_lists_size[cls] = 0;
+    }
+    _stats.cached_bytes = 0;
+    _disabled = disable;
+}
+
+namespace
+{
+
+// NOTE: the allocator is trivially destructible, thus it can be used by frames destroyed during the OS thread
+// shutdown (after the destruction of other thread local objects). The guard returns cached frames to the global
+// allocator when the OS thread finishes.
+thread_local constinit frame_allocator _frame_allocator;
+
+struct frame_allocator_guard
+{
+    ~frame_allocator_guard()
+    {
+        _frame_allocator.release(/*disable=*/true);
+    }
+};
+
+}  // namespace
+
+frame_allocator& get_frame_allocator() noexcept
+{
+    thread_local frame_allocator_guard guard;
+    return _frame_allocator;
+}
+
+}  // namespace co::impl
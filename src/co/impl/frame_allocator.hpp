@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace co
+{
+
+/// \brief statistics of the coroutine frame allocator of an OS thread (thus of an event loop)
+struct frame_allocator_stats
+{
+    // number of allocated frames
+    size_t allocations = 0;
+    // number of deallocated frames
+    size_t deallocations = 0;
+    // number of frames allocated from the free lists without calling the global operator new
+    size_t reused = 0;
+    // number of frames which are too large to be pooled
+    size_t large_allocations = 0;
+    // number of bytes kept in the free lists
+    size_t cached_bytes = 0;
+};
+
+namespace impl
+{
+
+/// \brief size class free list allocator for coroutine frames
+///
+/// Each OS thread has its own allocator, see get_frame_allocator(). Freed frames are kept in the free lists of the OS
+/// thread which frees them, so no synchronization is needed. A frame might be freed in another OS thread than it was
+/// allocated (see co::loop(n_workers, f)) because each block is allocated separately by the global operator new.
+class frame_allocator
+{
+public:
+    // frame sizes are rounded up to the granularity
+    static constexpr size_t granularity = 64;
+    static constexpr size_t n_size_classes = 32;
+    // frames larger than this are allocated by the global operator new directly
+    static constexpr size_t max_pooled_size = granularity * n_size_classes;
+    // the limit of the free list length per size class, the rest of frames are returned to the global allocator
+    static constexpr size_t max_cached_per_class = 1024;
+
+    void* allocate(size_t size);
+
+    void deallocate(void* ptr, size_t size) noexcept;
+
+    [[nodiscard]] const frame_allocator_stats& stats() const noexcept
+    {
+        return _stats;
+    }
+
+    /// \brief returns all cached frames to the global allocator. Further frees bypass the free lists if disable is set
+    void release(bool disable) noexcept;
+
+private:
+    static size_t size_class(size_t size) noexcept
+    {
+        return (size + granularity - 1) / granularity - 1;
+    }
+
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    std::array<free_block*, n_size_classes> _free_lists{};
+    std::array<size_t, n_size_classes> _free_lists_size{};
+    frame_allocator_stats _stats{};
+    bool _disabled = false;
+};
+
+/// \brief returns the frame allocator of the current OS thread
+frame_allocator& get_frame_allocator() noexcept;
+
+}  // namespace impl
+}  // namespace co
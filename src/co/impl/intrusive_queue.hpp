@@ -0,0 +1,67 @@
+#pragma once
+
+namespace co::impl
+{
+
+/// \brief intrusive singly linked FIFO queue, not thread safe
+///
+/// The node keeps the link to the next node in the member Next. The node can be in one queue at a time.
+template <typename T, T* T::*Next>
+class intrusive_queue
+{
+public:
+    intrusive_queue() = default;
+
+    intrusive_queue(const intrusive_queue&) = delete;
+    intrusive_queue(intrusive_queue&&) = delete;
+    intrusive_queue& operator=(const intrusive_queue&) = delete;
+    intrusive_queue& operator=(intrusive_queue&&) = delete;
+
+    void push_back(T* node) noexcept
+    {
+        node->*Next = nullptr;
+        if (_tail == nullptr)
+            _head = node;
+        else
+            _tail->*Next = node;
+        _tail = node;
+    }
+
+    /// \brief pops the first node, nullptr if the queue is empty
+    T* pop_front() noexcept
+    {
+        T* node = _head;
+        if (node == nullptr)
+            return nullptr;
+        _head = node->*Next;
+        if (_head == nullptr)
+            _tail = nullptr;
+        node->*Next = nullptr;
+        return node;
+    }
+
+    /// \brief moves all the nodes of other to the end of the queue
+    void splice_back(intrusive_queue& other) noexcept
+    {
+        if (other._head == nullptr)
+            return;
+        if (_tail == nullptr)
+            _head = other._head;
+        else
+            _tail->*Next = other._head;
+        _tail = other._tail;
+        other._head = nullptr;
+        other._tail = nullptr;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _head == nullptr;
+    }
+
+private:
+    T* _head = nullptr;
+    T* _tail = nullptr;
+};
+
+}  // namespace co::impl
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <co/loop_stats.hpp>
+
+namespace co::impl
+{
+
+/// \brief counter written by one OS thread and read by any OS thread
+///
+/// The writer doesn't need an atomic read-modify-write, so updates are as cheap as for a plain integer.
+class single_writer_counter
+{
+public:
+    void add(uint64_t value) noexcept
+    {
+        _value.store(_value.load(std::memory_order::relaxed) + value, std::memory_order::relaxed);
+    }
+
+    void update_max(uint64_t value) noexcept
+    {
+        if (value > _value.load(std::memory_order::relaxed))
+            _value.store(value, std::memory_order::relaxed);
+    }
+
+    [[nodiscard]] uint64_t load() const noexcept
+    {
+        return _value.load(std::memory_order::relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> _value = 0;
+};
+
+/// \brief histogram written by the event loop's OS thread, see co::loop_histogram
+class histogram_recorder
+{
+public:
+    void record(uint64_t value) noexcept
+    {
+        const size_t bucket = std::min<size_t>(std::bit_width(value), loop_histogram::n_buckets - 1);
+        _buckets[bucket].add(1);
+        _count.add(1);
+        _sum.add(value);
+        _max.update_max(value);
+    }
+
+    /// \brief get a copy of the histogram. Can be called from any OS thread, the copy might be slightly inconsistent
+    [[nodiscard]] loop_histogram snapshot() const noexcept
+    {
+        loop_histogram res;
+        for (size_t i = 0; i < loop_histogram::n_buckets; i++)
+            res.buckets[i] = _buckets[i].load();
+        res.count = _count.load();
+        res.sum = _sum.load();
+        res.max = _max.load();
+        return res;
+    }
+
+private:
+    std::array<single_writer_counter, loop_histogram::n_buckets> _buckets;
+    single_writer_counter _count;
+    single_writer_counter _sum;
+    single_writer_counter _max;
+};
+
+/// \brief instrumentation of the scheduler, updated by the event loop's OS thread only
+struct loop_counters
+{
+    single_writer_counter iterations;
+    single_writer_counter threads_started;
+    single_writer_counter threads_finished;
+    single_writer_counter resumes;
+    single_writer_counter remote_wakeups;
+    histogram_recorder ready_depth;
+    histogram_recorder drain_time;
+    histogram_recorder poll_time;
+    histogram_recorder loop_lag;
+
+    [[nodiscard]] loop_stats snapshot() const noexcept
+    {
+        loop_stats res;
+        res.iterations = iterations.load();
+        res.threads_finished = threads_finished.load();
+        res.threads_started = threads_started.load();
+        // the counters are read not atomically, so a concurrent snapshot might see more finished co::threads
+        res.threads_alive = res.threads_started - std::min(res.threads_started, res.threads_finished);
+        res.resumes = resumes.load();
+        res.remote_wakeups = remote_wakeups.load();
+        res.ready_depth = ready_depth.snapshot();
+        res.drain_time = drain_time.snapshot();
+        res.poll_time = poll_time.snapshot();
+        res.loop_lag = loop_lag.snapshot();
+        return res;
+    }
+};
+
+}  // namespace co::impl
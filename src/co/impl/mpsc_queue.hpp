@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+
+namespace co::impl
+{
+
+/// \brief intrusive lock free queue with multiple producers and a single consumer
+///
+/// Producers push nodes with a CAS loop, the consumer takes all pushed nodes at once. The node keeps the link to the
+/// next node in the member Next. The node can't be pushed again until it's drained by the consumer.
+template <typename T, T* T::*Next>
+class intrusive_mpsc_queue
+{
+public:
+    intrusive_mpsc_queue() = default;
+
+    intrusive_mpsc_queue(const intrusive_mpsc_queue&) = delete;
+    intrusive_mpsc_queue(intrusive_mpsc_queue&&) = delete;
+    intrusive_mpsc_queue& operator=(const intrusive_mpsc_queue&) = delete;
+    intrusive_mpsc_queue& operator=(intrusive_mpsc_queue&&) = delete;
+
+    /// \brief pushes the node. Can be called from any OS thread
+    /// \return true if the queue was empty, thus the consumer should be notified
+    bool push(T* node) noexcept
+    {
+        T* head = _head.load(std::memory_order::relaxed);
+        do
+        {
+            node->*Next = head;
+        } while (!_head.compare_exchange_weak(head, node, std::memory_order::release, std::memory_order::relaxed));
+        return head == nullptr;
+    }
+
+    /// \brief takes all the pushed nodes and calls f for each of them in the push order. Consumer side only
+    template <typename F>
+    void drain(F&& f)
+    {
+        T* node = _head.exchange(nullptr, std::memory_order::acquire);
+
+        // nodes are linked from the last pushed to the first one, reverse them
+        T* reversed = nullptr;
+        while (node != nullptr)
+        {
+            T* next = node->*Next;
+            node->*Next = reversed;
+            reversed = node;
+            node = next;
+        }
+
+        while (reversed != nullptr)
+        {
+            T* next = reversed->*Next;
+            reversed->*Next = nullptr;
+            f(reversed);
+            reversed = next;
+        }
+    }
+
+    /// \brief checks whether the queue is empty. The result might be stale immediately
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _head.load(std::memory_order::relaxed) == nullptr;
+    }
+
+private:
+    std::atomic<T*> _head = nullptr;
+};
+
+}  // namespace co::impl
@@ -1,12 +1,39 @@
+#include <algorithm>
+#include <utility>
 #include <co/check.hpp>
 #include <co/impl/scheduler.hpp>
+#include <co/impl/scheduler_group.hpp>
+#include <co/impl/thread_storage.hpp>
 
 namespace co::impl
 {
 
-void scheduler::run()
+void scheduler::init(scheduler_group* group)
 {
+    CO_CHECK(!_initialized) << "event loop is already running in this OS thread";
     uv_loop_init(&_uv_loop);
+    _time_origin = std::chrono::steady_clock::now() - std::chrono::nanoseconds(uv_hrtime());
+    _group = group;
+    _timers.init(&_uv_loop);
+    uv_idle_init(&_uv_loop, &_yield_idle);
+    uv_check_init(&_uv_loop, &_poll_check);
+    _poll_check.data = static_cast<void*>(this);
+    uv_check_start(&_poll_check, &scheduler::on_check);
+    // the statistics shouldn't keep the event loop alive
+    uv_unref((uv_handle_t*)&_poll_check);
+    _iteration_start = 0;
+    _poll_start = 0;
+    uv_async_init(&_uv_loop, &_inbox, &scheduler::on_inbox);
+    _inbox.data = static_cast<void*>(this);
+    _initialized = true;
+    update_inbox_ref();
+}
+
+void scheduler::run()
+{
+    if (!_initialized)
+        init(/*group=*/nullptr);
+
     uv_prepare_t uv_prepare;
     uv_prepare_init(&_uv_loop, &uv_prepare);
     uv_prepare.data = static_cast<void*>(this);
@@ -14,12 +41,18 @@ void scheduler::run()
     auto cb = [](uv_prepare_t* h)
     {
         auto& self = *static_cast<scheduler*>(h->data);
+        self.begin_iteration();
+        if (self._group != nullptr)
+            self._group->unpark(self);
         self.resume_ready();
 
         uv_unref((uv_handle_t*)h);
         if (uv_loop_alive(&self._uv_loop) == 0)
         {
             uv_close((uv_handle_t*)h, /*on_close*/nullptr);
+            // the group's worker closes the inbox when the group is stopped
+            if (self._group == nullptr)
+                self.close_handles();
         }
         else
         {
@@ -28,23 +61,305 @@ void scheduler::run()
     };
     uv_prepare_start(&uv_prepare, cb);
     uv_run(&_uv_loop, UV_RUN_DEFAULT);
+    end_iteration(uv_hrtime());
     uv_loop_close(&_uv_loop);
+    _group = nullptr;
+    _initialized = false;
+}
+
+void scheduler::ready(thread_storage* thread)
+{
+    CO_DCHECK(thread != nullptr);
+    CO_DCHECK(thread->suspended_coroutine);
+    _ready[priority_index(thread->priority_class)].push_back(thread);
+    _n_ready++;
+}
+
+void scheduler::wake(thread_storage* thread)
+{
+    CO_DCHECK(thread != nullptr);
+    CO_DCHECK(thread->suspended_coroutine);
+    // wakes from the event loop callbacks (timers, I/O) keep the FIFO order
+    if (!_resuming)
+    {
+        ready(thread);
+        return;
+    }
+    // the co::thread shouldn't overtake co::threads of higher classes
+    for (size_t i = 0; i < priority_index(thread->priority_class); i++)
+    {
+        if (!_ready[i].empty())
+        {
+            ready(thread);
+            return;
+        }
+    }
+    if (_next != nullptr)
+        ready(_next);
+    _next = thread;
+}
+
+void scheduler::yield(thread_storage* thread)
+{
+    CO_DCHECK(thread != nullptr);
+    CO_DCHECK(thread->suspended_coroutine);
+    _yielded[priority_index(thread->priority_class)].push_back(thread);
+    _n_yielded++;
+}
+
+void scheduler::post(thread_storage* thread)
+{
+    CO_DCHECK(thread != nullptr);
+    CO_DCHECK(thread->scheduler_ptr == this);
+    if (_inbox_queue.push(thread))
+        uv_async_send(&_inbox);
+}
+
+void scheduler::spawn(thread_storage* thread)
+{
+    CO_DCHECK(thread != nullptr);
+    CO_DCHECK(thread->suspended_coroutine);
+    if (_group == nullptr)
+    {
+        thread->scheduler_ptr = this;
+        ready(thread);
+        _counters.threads_started.add(1);
+        if (++_n_threads == 1)
+            update_inbox_ref();
+        return;
+    }
+
+    _group->thread_spawned();
+    {
+        std::unique_lock lk(_spawned_mutex);
+        _spawned.push_back(thread);
+        _spawned_size.fetch_add(1);
+    }
+    if (&get_scheduler() == this)
+        _group->wake_idle(*this);
+    else
+        uv_async_send(&_inbox);
+}
+
+void scheduler::thread_finished()
+{
+    CO_DCHECK(_n_threads > 0);
+    _counters.threads_finished.add(1);
+    if (--_n_threads == 0)
+        update_inbox_ref();
+    if (_group != nullptr)
+        _group->thread_finished();
+}
+
+void scheduler::begin_iteration()
+{
+    const uint64_t now = uv_hrtime();
+    end_iteration(now);
+    _iteration_start = now;
+    _counters.iterations.add(1);
 }
 
-void scheduler::ready(scheduler::coroutine_handle handle)
+void scheduler::end_iteration(uint64_t now)
 {
-    CO_DCHECK(handle);
-    _ready.push(handle);
+    if (_iteration_start == 0)
+        return;
+    const uint64_t duration = now - _iteration_start;
+    _counters.loop_lag.record(duration - std::min(duration, _last_poll_time));
+    _iteration_start = 0;
+    _last_poll_time = 0;
 }
 
 void scheduler::resume_ready()
 {
-    while (!_ready.empty())
+    const uint64_t drain_start = uv_hrtime();
+    // co::threads yielded in the previous iteration go after the ones woken up by I/O and timers
+    for (size_t i = 0; i < n_priorities; i++)
+        _ready[i].splice_back(_yielded[i]);
+    _n_ready += std::exchange(_n_yielded, 0);
+    _counters.ready_depth.record(_n_ready);
+
+    _resuming = true;
+    size_t n_resumed = 0;
+    while (true)
+    {
+        while (n_resumed < max_resumes_per_iteration)
+        {
+            thread_storage* thread = nullptr;
+            if (_next != nullptr && _lifo_runs < max_lifo_runs)
+            {
+                thread = std::exchange(_next, nullptr);
+                _lifo_runs++;
+            }
+            else
+            {
+                // the LIFO slot has been used too many times in a row, let the queued co::threads run
+                if (_next != nullptr)
+                    ready(std::exchange(_next, nullptr));
+                thread = pop_ready();
+                _lifo_runs = 0;
+            }
+            if (thread == nullptr)
+                break;
+            resume(thread);
+            n_resumed++;
+        }
+
+        // the worker isn't idle, but let the event loop poll I/O before resuming the rest of co::threads
+        if (_group == nullptr || _n_yielded > 0 || n_resumed >= max_resumes_per_iteration)
+            break;
+
+        thread_storage* thread = pop_spawned();
+        if (thread == nullptr)
+            thread = _group->steal(*this);
+
+        if (thread != nullptr)
+            start(thread);
+        else if (_group->park(*this))
+            break;
+    }
+    _resuming = false;
+    // the LIFO slot doesn't outlive the iteration, the co::thread waits in its ready queue
+    if (_next != nullptr)
+        ready(std::exchange(_next, nullptr));
+    _counters.resumes.add(n_resumed);
+
+    if (_n_yielded == 0 && _n_ready == 0)
+        uv_idle_stop(&_yield_idle);
+    else
+        uv_idle_start(&_yield_idle, [](uv_idle_t*) {});
+
+    const uint64_t drain_end = uv_hrtime();
+    _counters.drain_time.record(drain_end - drain_start);
+    _poll_start = drain_end;
+}
+
+thread_storage* scheduler::pop_ready()
+{
+    for (int pass = 0; pass < 2; pass++)
+    {
+        bool has_ready = false;
+        for (size_t i = 0; i < n_priorities; i++)
+        {
+            if (_ready[i].empty())
+                continue;
+            has_ready = true;
+            if (_priority_credits[i] > 0)
+            {
+                _priority_credits[i]--;
+                _n_ready--;
+                return _ready[i].pop_front();
+            }
+        }
+        if (!has_ready)
+            return nullptr;
+        // all the ready classes have spent their credits, start a new round
+        _priority_credits = _priority_weights;
+    }
+
+    // only zero weight classes have ready co::threads, serve them strictly
+    for (auto& queue : _ready)
     {
-        auto coro_handle = _ready.front();
-        _ready.pop();
-        coro_handle.resume();
+        if (!queue.empty())
+        {
+            _n_ready--;
+            return queue.pop_front();
+        }
     }
+    return nullptr;
+}
+
+void scheduler::resume(thread_storage* thread)
+{
+    auto coro_handle = std::exchange(thread->suspended_coroutine, std::coroutine_handle<>{});
+    CO_DCHECK(coro_handle);
+    coro_handle.resume();
+}
+
+thread_storage* scheduler::pop_spawned()
+{
+    if (_spawned_size.load(std::memory_order::relaxed) == 0)
+        return nullptr;
+
+    std::unique_lock lk(_spawned_mutex);
+    if (_spawned.empty())
+        return nullptr;
+
+    thread_storage* thread = _spawned.front();
+    _spawned.pop_front();
+    _spawned_size.fetch_sub(1);
+    return thread;
+}
+
+thread_storage* scheduler::steal_spawned()
+{
+    std::unique_lock lk(_spawned_mutex);
+    if (_spawned.empty())
+        return nullptr;
+
+    // the owner takes co::threads from the front, thieves from the back
+    thread_storage* thread = _spawned.back();
+    _spawned.pop_back();
+    _spawned_size.fetch_sub(1);
+    return thread;
+}
+
+void scheduler::start(thread_storage* thread)
+{
+    CO_DCHECK(thread != nullptr);
+    thread->scheduler_ptr = this;
+    _n_threads++;
+    _counters.threads_started.add(1);
+    _counters.resumes.add(1);
+    auto coro_handle = thread->suspended_coroutine;
+    thread->suspended_coroutine = std::coroutine_handle<>{};
+    coro_handle.resume();
+}
+
+void scheduler::update_inbox_ref()
+{
+    // the group's worker keeps the inbox referenced until the group is stopped
+    if (!_initialized || _group != nullptr)
+        return;
+
+    if (_n_threads > 0)
+        uv_ref((uv_handle_t*)&_inbox);
+    else
+        uv_unref((uv_handle_t*)&_inbox);
+}
+
+void scheduler::close_handles()
+{
+    uv_close((uv_handle_t*)&_yield_idle, /*on_close*/nullptr);
+    uv_close((uv_handle_t*)&_poll_check, /*on_close*/nullptr);
+    uv_close((uv_handle_t*)&_inbox, /*on_close*/nullptr);
+    _timers.close();
+}
+
+void scheduler::on_inbox(uv_async_t* handle)
+{
+    CO_DCHECK(handle->data != nullptr);
+    auto& self = *static_cast<scheduler*>(handle->data);
+    self._inbox_queue.drain(
+        [&self](thread_storage* thread)
+        {
+            CO_DCHECK(thread->suspended_coroutine.address() != nullptr);
+            self._counters.remote_wakeups.add(1);
+            self.ready(thread);
+        });
+
+    // new co::threads will be picked up in the prepare phase of the next loop iteration
+    if (self._group != nullptr && self._group->is_stopped())
+        self.close_handles();
+}
+
+void scheduler::on_check(uv_check_t* handle)
+{
+    CO_DCHECK(handle->data != nullptr);
+    auto& self = *static_cast<scheduler*>(handle->data);
+    if (self._poll_start == 0)
+        return;
+    self._last_poll_time = uv_hrtime() - std::exchange(self._poll_start, 0);
+    self._counters.poll_time.record(self._last_poll_time);
 }
 
 scheduler& get_scheduler()
@@ -53,4 +368,4 @@ scheduler& get_scheduler()
     return _scheduler;
 }
 
-}  // namespace co::impl
\ No newline at end of file
+}  // namespace co::impl
@@ -1,18 +1,30 @@
 #pragma once
 
-#include <queue>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
 #include <co/std.hpp>
+#include <co/impl/intrusive_queue.hpp>
+#include <co/impl/loop_counters.hpp>
+#include <co/impl/mpsc_queue.hpp>
+#include <co/impl/thread_storage.hpp>
+#include <co/impl/timer_wheel.hpp>
 #include <uv.h>
 
 namespace co::impl
 {
 
+class scheduler_group;
+
 /// \brief scheduler is responsible for running event loop, queueing co::threads ready to resume
 ///
 /// user code should not interact with this class
 class scheduler
 {
     using coroutine_handle = std::coroutine_handle<>;
+    friend class scheduler_group;
 
 public:
     /// \brief run event loop until all co::thread will be finished
@@ -20,8 +32,34 @@ public:
     /// run() blocks current OS thread
     void run();
 
-    /// \brief put coroutine handle to the ready queue
-    void ready(coroutine_handle handle);
+    /// \brief put the suspended co::thread to the tail of the ready queue of its priority class
+    void ready(thread_storage* thread);
+
+    /// \brief wakes up the suspended co::thread of this scheduler from the same OS thread
+    ///
+    /// A co::thread woken up by a running co::thread is put to the LIFO slot, so it runs next while the data passed to
+    /// it is still in the cache. The slot keeps only one co::thread, the previous one goes to the tail of the ready
+    /// queue. To be fair to the other ready co::threads, the slot is bypassed after max_lifo_runs consecutive runs.
+    /// The slot isn't used if there are ready co::threads of a higher priority class.
+    void wake(thread_storage* thread);
+
+    /// \brief puts the suspended co::thread to the queue which is resumed in the next iteration of the event loop
+    void yield(thread_storage* thread);
+
+    /// \brief wakes up a co::thread of this scheduler from another OS thread
+    ///
+    /// The co::thread is put to the inbox which is drained by the scheduler's OS thread. Wakes that come before the
+    /// scheduler drains the inbox are batched into one uv_async_send call.
+    void post(thread_storage* thread);
+
+    /// \brief schedule a new co::thread. thread->suspended_coroutine is the entry point of the co::thread
+    ///
+    /// If the scheduler is a worker of a group, the co::thread can be stolen by another worker before it starts.
+    /// Once started, the co::thread never leaves the worker.
+    void spawn(thread_storage* thread);
+
+    /// \brief should be called by a co::thread right before it finishes
+    void thread_finished();
 
     /// \brief get raw uv_loop object
     uv_loop_t* uv_loop()
@@ -29,16 +67,173 @@ public:
         return &_uv_loop;
     }
 
+    /// \brief returns true while the event loop is initialized or running
+    [[nodiscard]] bool is_running() const noexcept
+    {
+        return _initialized;
+    }
+
+    /// \brief get the time of the event loop. The time is cached at the beginning of the loop iteration unless precise
+    /// time is on
+    std::chrono::steady_clock::time_point now() noexcept
+    {
+        // the high resolution timers read the clock anyway
+        if (_timers.high_resolution())
+            return _time_origin + std::chrono::nanoseconds(uv_hrtime());
+        if (_precise_time)
+            update_time();
+        return _time_origin + std::chrono::milliseconds(uv_now(&_uv_loop));
+    }
+
+    /// \brief refreshes the cached time of the event loop
+    void update_time() noexcept
+    {
+        uv_update_time(&_uv_loop);
+    }
+
+    /// \brief if precise time is on, the time of the event loop is refreshed on every read
+    void set_precise_time(bool precise) noexcept
+    {
+        _precise_time = precise;
+    }
+
+    [[nodiscard]] bool precise_time() const noexcept
+    {
+        return _precise_time;
+    }
+
+    /// \brief sets the number of operations a co::thread can complete without suspension before it's forced to yield.
+    /// 0 means no limit
+    void set_thread_budget(uint32_t budget) noexcept
+    {
+        _thread_budget = budget;
+    }
+
+    [[nodiscard]] uint32_t thread_budget() const noexcept
+    {
+        return _thread_budget;
+    }
+
+    /// \brief sets the number of co::threads of each priority class resumed in a round when all the classes have ready
+    /// co::threads. A class with zero weight is served only when all the weighted classes are empty
+    void set_priority_weights(const std::array<uint32_t, n_priorities>& weights) noexcept
+    {
+        _priority_weights = weights;
+        _priority_credits = weights;
+    }
+
+    /// \brief get a snapshot of the event loop statistics. Can be called from any OS thread
+    [[nodiscard]] loop_stats stats() const noexcept
+    {
+        return _counters.snapshot();
+    }
+
+    /// \brief get the timer wheel which drives timeouts of the scheduler's co::threads
+    timer_wheel& timers()
+    {
+        return _timers;
+    }
+
 private:
-    /// \brief consumes the ready queue and resume coroutines
+    /// \brief initializes event loop. group is not null when the scheduler is a worker of the group
+    void init(scheduler_group* group);
+
+    /// \brief accounts the previous iteration of the event loop, called in the beginning of the prepare phase
+    void begin_iteration();
+
+    /// \brief accounts the loop lag of the current iteration
+    void end_iteration(uint64_t now);
+
+    /// \brief consumes the ready queues and resume coroutines, at most max_resumes_per_iteration of them before the event
+    /// loop polls I/O again
     void resume_ready();
 
+    /// \brief pops a not started co::thread from the own queue, nullptr if the queue is empty
+    thread_storage* pop_spawned();
+
+    /// \brief pops a not started co::thread on behalf of another worker, nullptr if the queue is empty
+    thread_storage* steal_spawned();
+
+    /// \brief binds the co::thread to the scheduler and resumes it for the first time
+    void start(thread_storage* thread);
+
+    /// \brief keeps the event loop alive while there are co::threads that might be woken up from another OS thread
+    void update_inbox_ref();
+
+    /// \brief closes the handles which live during the whole event loop run
+    void close_handles();
+
+    /// \brief pops the next ready co::thread according to the priority weights, nullptr if there are no ready
+    /// co::threads
+    thread_storage* pop_ready();
+
+    /// \brief resumes the suspended coroutine of the co::thread
+    static void resume(thread_storage* thread);
+
+    static void on_inbox(uv_async_t* handle);
+
+    /// \brief measures the poll phase, the check phase goes right after it
+    static void on_check(uv_check_t* handle);
+
 private:
     uv_loop_t _uv_loop;
-    std::queue<coroutine_handle> _ready;
+    bool _initialized = false;
+    // steady_clock time of the zero uv_hrtime()
+    std::chrono::steady_clock::time_point _time_origin;
+    bool _precise_time = false;
+    static constexpr size_t max_lifo_runs = 3;
+    // co::threads that keep waking each other don't starve I/O and timers
+    static constexpr size_t max_resumes_per_iteration = 256;
+
+    using ready_queue = intrusive_queue<thread_storage, &thread_storage::ready_next>;
+
+    // ready queues per priority class
+    std::array<ready_queue, n_priorities> _ready;
+    std::array<uint32_t, n_priorities> _priority_weights = { 8, 4, 1 };
+    // number of co::threads each class can resume until the credits are refilled
+    std::array<uint32_t, n_priorities> _priority_credits = _priority_weights;
+    // the co::thread to run next, see wake()
+    thread_storage* _next = nullptr;
+    // number of consecutive runs from the LIFO slot
+    size_t _lifo_runs = 0;
+    // true while the ready co::threads are being resumed
+    bool _resuming = false;
+    // co::threads which yielded per priority class, they are resumed in the next iteration of the event loop
+    std::array<ready_queue, n_priorities> _yielded;
+    size_t _n_yielded = 0;
+    // is active while there are yielded or ready co::threads, so the event loop doesn't block in the poll phase
+    uv_idle_t _yield_idle;
+    uint32_t _thread_budget = 128;
+    // number of co::threads bound to the scheduler
+    size_t _n_threads = 0;
+    // number of co::threads in the ready queues
+    size_t _n_ready = 0;
+
+    loop_counters _counters;
+    // uv_hrtime() of the beginning of the current iteration and of the poll phase, 0 if unknown
+    uint64_t _iteration_start = 0;
+    uint64_t _poll_start = 0;
+    uint64_t _last_poll_time = 0;
+    uv_check_t _poll_check;
+
+    timer_wheel _timers;
+
+    // co::threads woken up from other OS threads
+    intrusive_mpsc_queue<thread_storage, &thread_storage::inbox_next> _inbox_queue;
+    // wakes the scheduler when there are co::threads in the inbox, co::threads to steal or the group is stopping
+    uv_async_t _inbox;
+
+    // NOTE: the members below are used only when the scheduler is a worker of a group
+    scheduler_group* _group = nullptr;
+    // not started co::threads, can be stolen by other workers
+    std::mutex _spawned_mutex;
+    std::deque<thread_storage*> _spawned;
+    std::atomic<size_t> _spawned_size = 0;
+    // the worker has no work and is (going to be) blocked in the event loop poll phase
+    std::atomic<bool> _idle = false;
 };
 
 /// \brief returns thread local scheduler object
 scheduler& get_scheduler();
 
-}  // namespace co::impl
\ No newline at end of file
+}  // namespace co::impl
@@ -0,0 +1,275 @@
+#include <co/impl/scheduler_group.hpp>
+
+#include <algorithm>
+#include <vector>
+#include <co/check.hpp>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace co::impl
+{
+
+namespace
+{
+
+thread_local std::optional<size_t> this_worker_index;
+
+/// \brief the cores the current OS thread is allowed to run on (taskset, cgroup cpusets, containers)
+std::vector<size_t> allowed_cores()
+{
+    std::vector<size_t> res;
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+    {
+        for (size_t core = 0; core < CPU_SETSIZE; core++)
+        {
+            if (CPU_ISSET(core, &cpu_set))
+                res.push_back(core);
+        }
+    }
+#elif defined(_WIN32)
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) != 0)
+    {
+        for (size_t core = 0; core < sizeof(DWORD_PTR) * 8; core++)
+        {
+            if (process_mask & (DWORD_PTR(1) << core))
+                res.push_back(core);
+        }
+    }
+#endif
+    return res;
+}
+
+/// \brief pins the worker to one of the allowed cores. Returns the core, std::nullopt if the worker runs unpinned
+std::optional<size_t> pin_current_thread(size_t index, const std::vector<size_t>& cores)
+{
+    if (cores.empty())
+        return std::nullopt;
+    const size_t core = cores[index % cores.size()];
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0)
+        return std::nullopt;
+    return core;
+#elif defined(_WIN32)
+    if (SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) == 0)
+        return std::nullopt;
+    return core;
+#else
+    // thread affinity is not supported on this platform
+    return std::nullopt;
+#endif
+}
+
+}  // namespace
+
+scheduler_group::scheduler_group(size_t n_workers, bool work_stealing, bool pin_threads)
+    : _n_workers(n_workers)
+    , _work_stealing(work_stealing)
+    , _pin_threads(pin_threads)
+    , _pinned_cores(n_workers)
+    , _schedulers(n_workers, nullptr)
+{
+    CO_CHECK(n_workers > 0) << "scheduler_group needs at least one worker";
+    // taken before any worker is pinned, the first worker may run in the current OS thread
+    if (_pin_threads)
+        _allowed_cores = allowed_cores();
+}
+
+scheduler_group::~scheduler_group()
+{
+    CO_CHECK(_threads.empty()) << "scheduler_group should be joined before being destructed";
+}
+
+void scheduler_group::run(const std::function<void()>& on_start)
+{
+    _threads.reserve(_n_workers - 1);
+    for (size_t i = 1; i < _n_workers; i++)
+        start_worker(i);
+
+    init_worker(0);
+    // co::threads spawned by on_start might be stolen and finished even before on_start returns
+    _joining.store(true);
+    on_start();
+    if (_alive.load() == 0)
+        stop();
+    get_scheduler().run();
+    this_worker_index = std::nullopt;
+
+    for (auto& thread : _threads)
+        thread.join();
+    _threads.clear();
+}
+
+void scheduler_group::start()
+{
+    _threads.reserve(_n_workers);
+    for (size_t i = 0; i < _n_workers; i++)
+        start_worker(i);
+
+    std::unique_lock lk(_mutex);
+    _cv.wait(lk, [this]() { return _n_initialized == _n_workers; });
+}
+
+void scheduler_group::join()
+{
+    _joining.store(true);
+    if (_alive.load() == 0)
+        stop();
+
+    for (auto& thread : _threads)
+        thread.join();
+    _threads.clear();
+}
+
+scheduler& scheduler_group::worker(size_t index)
+{
+    CO_CHECK(index < _n_workers) << "worker index " << index << " is out of range, the group size is " << _n_workers;
+    CO_DCHECK(_schedulers[index] != nullptr);
+    return *_schedulers[index];
+}
+
+std::optional<size_t> scheduler_group::pinned_core(size_t index) const
+{
+    CO_CHECK(index < _n_workers) << "worker index " << index << " is out of range, the group size is " << _n_workers;
+    return _pinned_cores[index];
+}
+
+std::optional<size_t> scheduler_group::current_worker_index()
+{
+    return this_worker_index;
+}
+
+void scheduler_group::start_worker(size_t index)
+{
+    _threads.emplace_back(
+        [this, index]()
+        {
+            // published to start() by the startup barrier in init_worker()
+            if (_pin_threads)
+                _pinned_cores[index] = pin_current_thread(index, _allowed_cores);
+            init_worker(index);
+            get_scheduler().run();
+            this_worker_index = std::nullopt;
+        });
+}
+
+void scheduler_group::init_worker(size_t index)
+{
+    scheduler& worker = get_scheduler();
+    worker.init(this);
+    this_worker_index = index;
+
+    std::unique_lock lk(_mutex);
+    _schedulers[index] = &worker;
+    _n_initialized++;
+    _cv.notify_all();
+    // workers look into each other's queues, so all of them should be registered before running
+    _cv.wait(lk, [this]() { return _n_initialized == _n_workers; });
+}
+
+void scheduler_group::thread_spawned()
+{
+    CO_CHECK(!is_stopped()) << "the group is already stopped";
+    _alive.fetch_add(1);
+}
+
+void scheduler_group::thread_finished()
+{
+    // the last co::thread of the joined group is finished
+    if (_alive.fetch_sub(1) == 1 && _joining.load())
+        stop();
+}
+
+void scheduler_group::stop()
+{
+    if (_stopped.exchange(true))
+        return;
+
+    for (scheduler* worker : _schedulers)
+        uv_async_send(&worker->_inbox);
+}
+
+void scheduler_group::wake_idle(scheduler& self)
+{
+    if (!_work_stealing || _n_idle.load() == 0)
+        return;
+
+    for (scheduler* worker : _schedulers)
+    {
+        if (worker != &self && worker->_idle.exchange(false))
+        {
+            _n_idle.fetch_sub(1);
+            uv_async_send(&worker->_inbox);
+            return;
+        }
+    }
+}
+
+thread_storage* scheduler_group::steal(scheduler& thief)
+{
+    if (!_work_stealing)
+        return nullptr;
+
+    while (true)
+    {
+        // steal from the busiest worker
+        scheduler* victim = nullptr;
+        size_t victim_size = 0;
+        for (scheduler* worker : _schedulers)
+        {
+            const size_t size = worker->_spawned_size.load(std::memory_order::relaxed);
+            if (worker != &thief && size > victim_size)
+            {
+                victim = worker;
+                victim_size = size;
+            }
+        }
+        if (victim == nullptr)
+            return nullptr;
+
+        if (thread_storage* thread = victim->steal_spawned(); thread != nullptr)
+            return thread;
+        // somebody was faster, try again
+    }
+}
+
+bool scheduler_group::park(scheduler& self)
+{
+    if (!_work_stealing)
+        return true;
+
+    self._idle.store(true);
+    _n_idle.fetch_add(1);
+
+    // A spawning worker increments the queue size first and then checks _n_idle. Here it's vice versa,
+    // so either we see the new co::thread or the spawning worker sees us idle.
+    for (scheduler* worker : _schedulers)
+    {
+        if (worker != &self && worker->_spawned_size.load() > 0)
+        {
+            unpark(self);
+            return false;
+        }
+    }
+    return true;
+}
+
+void scheduler_group::unpark(scheduler& self)
+{
+    if (self._idle.exchange(false))
+        _n_idle.fetch_sub(1);
+}
+
+}  // namespace co::impl
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <co/impl/scheduler.hpp>
+
+namespace co::impl
+{
+
+/// \brief a set of schedulers, each one runs its own event loop in a separate OS thread
+///
+/// When work stealing is enabled, an idle worker takes not yet started co::threads from the queues of busy workers.
+/// A started co::thread never migrates, because its uv handles are bound to the worker's event loop.
+/// The group stops when all co::threads of all workers are finished and the group is joined.
+///
+/// user code should not interact with this class
+class scheduler_group
+{
+    friend class scheduler;
+
+public:
+    scheduler_group(size_t n_workers, bool work_stealing, bool pin_threads = false);
+
+    ~scheduler_group();
+
+    scheduler_group(const scheduler_group&) = delete;
+    scheduler_group(scheduler_group&&) = delete;
+    scheduler_group& operator=(const scheduler_group&) = delete;
+    scheduler_group& operator=(scheduler_group&&) = delete;
+
+    /// \brief runs the workers. The current OS thread becomes the first worker.
+    ///
+    /// on_start is called on the first worker when all workers are ready. run() blocks until all co::threads will be
+    /// finished
+    void run(const std::function<void()>& on_start);
+
+    /// \brief runs all workers in new OS threads. Returns when all workers are ready to accept co::threads
+    void start();
+
+    /// \brief lets the group stop when there are no co::threads left and waits for the workers' OS threads
+    void join();
+
+    [[nodiscard]] size_t size() const
+    {
+        return _n_workers;
+    }
+
+    /// \brief get the worker's scheduler. The group should be started
+    scheduler& worker(size_t index);
+
+    /// \brief get the core the worker is pinned to, std::nullopt if it isn't pinned. The group should be started
+    [[nodiscard]] std::optional<size_t> pinned_core(size_t index) const;
+
+    /// \brief get the index of the worker running in the current OS thread, std::nullopt outside of a group
+    static std::optional<size_t> current_worker_index();
+
+private:
+    /// \brief initializes the worker's event loop and waits until all workers are initialized
+    void init_worker(size_t index);
+
+    /// \brief runs a worker in a new OS thread
+    void start_worker(size_t index);
+
+    /// \brief closes workers' event loops
+    void stop();
+
+    void thread_spawned();
+    void thread_finished();
+
+    /// \brief wakes up one of idle workers (if any) to steal a new co::thread from self
+    void wake_idle(scheduler& self);
+
+    /// \brief takes a not started co::thread from some other worker
+    thread_storage* steal(scheduler& thief);
+
+    /// \brief marks the worker as idle. Returns false if there is work to steal and the worker should not sleep
+    bool park(scheduler& self);
+
+    /// \brief removes idle mark from the worker
+    void unpark(scheduler& self);
+
+    [[nodiscard]] bool is_stopped() const
+    {
+        return _stopped.load(std::memory_order::acquire);
+    }
+
+private:
+    const size_t _n_workers;
+    const bool _work_stealing;
+    const bool _pin_threads;
+    // the cores the workers are pinned to, see pin_threads
+    std::vector<size_t> _allowed_cores;
+    // the core of each pinned worker, std::nullopt if the worker isn't pinned
+    std::vector<std::optional<size_t>> _pinned_cores;
+    std::vector<scheduler*> _schedulers;
+    std::vector<std::thread> _threads;
+
+    // startup barrier
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    size_t _n_initialized = 0;
+
+    std::atomic<size_t> _alive = 0;
+    std::atomic<size_t> _n_idle = 0;
+    std::atomic<bool> _joining = false;
+    std::atomic<bool> _stopped = false;
+};
+
+}  // namespace co::impl
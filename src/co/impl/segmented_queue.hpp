@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include <co/check.hpp>
+
+namespace co::impl
+{
+
+/// \brief FIFO queue of linked fixed size segments, the buffer of the unbounded channels
+///
+/// Segments are allocated when the values come and released as soon as they are drained, so the memory follows the
+/// number of values in the queue. The queue keeps up to max_spare_segments released segments for reuse, thus steady
+/// traffic doesn't call the global allocator whichever OS threads push and pop. The queue lives in the shared state of
+/// the channel and is used under its mutex, so the spare segments are the channel's own pool. The limit is soft: no
+/// memory is reserved for it, full() only says that the queue holds limit values or more.
+template <typename T>
+class segmented_queue
+{
+    static constexpr size_t segment_bytes = 1024;
+    static constexpr size_t segment_size = std::max<size_t>(1, segment_bytes / sizeof(T));
+    // an idle queue keeps at most this number of segments
+    static constexpr size_t max_spare_segments = 2;
+
+    struct segment
+    {
+        segment* next = nullptr;
+        alignas(T) std::byte storage[segment_size * sizeof(T)];
+
+        T* item(size_t pos) noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(storage) + pos);
+        }
+    };
+
+public:
+    static constexpr size_t no_limit = std::numeric_limits<size_t>::max();
+
+    explicit segmented_queue(size_t limit = no_limit)
+        : _limit(limit)
+    {}
+
+    segmented_queue(const segmented_queue&) = delete;
+    segmented_queue& operator=(const segmented_queue&) = delete;
+
+    ~segmented_queue()
+    {
+        while (!empty())
+            pop_front();
+        while (_spare != nullptr)
+            delete std::exchange(_spare, _spare->next);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    [[nodiscard]] bool full() const noexcept
+    {
+        return _size >= _limit;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    template <typename T2>
+    void push_back(T2&& t)
+    {
+        if (_tail == nullptr || _tail_pos == segment_size)
+        {
+            segment* seg = allocate_segment();
+            try
+            {
+                std::construct_at(reinterpret_cast<T*>(seg->storage), std::forward<T2>(t));
+            }
+            catch (...)
+            {
+                free_segment(seg);
+                throw;
+            }
+            if (_tail == nullptr)
+                _head = seg;
+            else
+                _tail->next = seg;
+            _tail = seg;
+            _tail_pos = 1;
+        }
+        else
+        {
+            std::construct_at(reinterpret_cast<T*>(_tail->storage) + _tail_pos, std::forward<T2>(t));
+            _tail_pos++;
+        }
+        _size++;
+    }
+
+    T& front() noexcept
+    {
+        CO_DCHECK(!empty());
+        return *_head->item(_head_pos);
+    }
+
+    void pop_front() noexcept
+    {
+        CO_DCHECK(!empty());
+        std::destroy_at(_head->item(_head_pos));
+        _head_pos++;
+        _size--;
+        if (_size == 0)
+        {
+            // the last segment is released too, an idle queue holds the spare segments only
+            free_segment(_head);
+            _head = _tail = nullptr;
+            _head_pos = _tail_pos = 0;
+        }
+        else if (_head_pos == segment_size)
+        {
+            segment* next = _head->next;
+            free_segment(_head);
+            _head = next;
+            _head_pos = 0;
+        }
+    }
+
+private:
+    segment* allocate_segment()
+    {
+        if (_spare == nullptr)
+            return new segment;
+        segment* seg = std::exchange(_spare, _spare->next);
+        seg->next = nullptr;
+        _n_spare--;
+        return seg;
+    }
+
+    void free_segment(segment* seg) noexcept
+    {
+        if (_n_spare == max_spare_segments)
+        {
+            delete seg;
+            return;
+        }
+        seg->next = _spare;
+        _spare = seg;
+        _n_spare++;
+    }
+
+    size_t _limit;
+    size_t _size = 0;
+    segment* _head = nullptr;
+    size_t _head_pos = 0;
+    segment* _tail = nullptr;
+    size_t _tail_pos = 0;
+    // released segments kept for reuse, linked by next
+    segment* _spare = nullptr;
+    size_t _n_spare = 0;
+};
+
+}  // namespace co::impl
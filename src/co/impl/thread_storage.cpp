@@ -3,6 +3,7 @@
 
 namespace co::impl
 {
+
 void wake_thread(thread_storage* thread)
 {
     CO_DCHECK(thread != nullptr);
@@ -11,12 +12,29 @@ void wake_thread(thread_storage* thread)
         // We are currently in the same thread where the co::thread lives.
         // So we can schedule the corourine without std::thread sync.
         CO_DCHECK(thread->suspended_coroutine.address() != nullptr);
-        thread->scheduler_ptr->ready(thread->suspended_coroutine);
-        thread->suspended_coroutine = std::coroutine_handle<>{};
+        thread->scheduler_ptr->wake(thread);
     }
     else
     {
-        thread->async_signal.send();
+        thread->scheduler_ptr->post(thread);
     }
 }
+
+bool consume_budget() noexcept
+{
+    thread_storage* thread = get_this_thread_storage_ptr();
+    if (thread == nullptr)
+        return false;
+    const uint32_t budget = thread->scheduler_ptr->thread_budget();
+    return budget != 0 && ++thread->budget_used >= budget;
+}
+
+void yield_thread(thread_storage* thread, std::coroutine_handle<> awaiting_coroutine) noexcept
+{
+    CO_DCHECK(thread != nullptr);
+    CO_DCHECK(thread->scheduler_ptr == &get_scheduler());
+    current_thread_on_suspend(awaiting_coroutine);
+    thread->scheduler_ptr->yield(thread);
+}
+
 }  // namespace co::impl
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <string>
-#include <co/impl/async_signal.hpp>
-#include <co/impl/timer.hpp>
+#include <co/check.hpp>
+#include <co/priority.hpp>
+#include <co/std.hpp>
 #include <co/stop_token.hpp>
 
 namespace co::impl
@@ -11,41 +14,79 @@ class scheduler;
 
 struct thread_storage
 {
+    // empty if the name isn't set explicitly, see get_name()
     std::string name;
     uint64_t id;
-    stop_source stop;
-    timer _timer{};
-    async_signal async_signal{};
+    co::priority priority_class = co::priority::normal;
+    // created on demand, see get_stop_source()
+    stop_source stop{ nostopstate };
+    // the stop source and the name are requested both from the OS thread owning the co::thread object and from the
+    // worker running the co::thread, thus the lazy initialization is done once for all of them
+    std::once_flag stop_once;
+    std::atomic<bool> stop_created = false;
+    std::once_flag name_once;
     // ptr to the scheduler which the co::thread belongs to
     scheduler* scheduler_ptr = nullptr;
     std::coroutine_handle<> suspended_coroutine = nullptr;
+    // link in the scheduler's inbox, used when the co::thread is woken up from another OS thread
+    thread_storage* inbox_next = nullptr;
+    // link in the scheduler's ready or yielded queue
+    thread_storage* ready_next = nullptr;
+    // number of operations completed without suspension since the last suspension, see consume_budget()
+    uint32_t budget_used = 0;
+
+    /// \brief get the name of the co::thread, the default name is formatted on the first call
+    const std::string& get_name()
+    {
+        std::call_once(name_once,
+                       [this]()
+                       {
+                           if (name.empty())
+                               name = "co::thread" + std::to_string(id);
+                       });
+        return name;
+    }
+
+    /// \brief get the stop source of the co::thread, the stop state is allocated on the first call
+    stop_source& get_stop_source()
+    {
+        std::call_once(stop_once,
+                       [this]()
+                       {
+                           stop = stop_source();
+                           stop_created.store(true, std::memory_order::release);
+                       });
+        return stop;
+    }
+
+    /// \brief returns true if a stop has been requested, doesn't allocate the stop state
+    bool stop_requested() const noexcept
+    {
+        return stop_created.load(std::memory_order::acquire) && stop.stop_requested();
+    }
 };
 
 void wake_thread(thread_storage*);
 
-inline std::shared_ptr<thread_storage> create_thread_storage(const std::string& thread_name,
-                                                             uint64_t id,
-                                                             scheduler* scheduler_ptr)
-{
-    auto storage = std::make_shared<thread_storage>();
-    storage->id = id;
-    if (thread_name.empty())
-        storage->name = "co::thread" + std::to_string(storage->id);
-    else
-        storage->name = thread_name;
+/// \brief counts an operation completed by the current co::thread without suspension (the ready path of channels,
+/// mutexes, events). Returns true if the co::thread has exhausted its budget and should yield
+bool consume_budget() noexcept;
 
-    CO_DCHECK(scheduler_ptr != nullptr);
-    storage->scheduler_ptr = scheduler_ptr;
-    storage->async_signal.data = static_cast<void*>(storage.get());
-    auto callback = [](void* data)
-    {
-        CO_DCHECK(data != nullptr);
-        thread_storage* storage = static_cast<thread_storage*>(data);
-        wake_thread(storage);
-    };
-    storage->async_signal.callback = callback;
+/// \brief suspends the co::thread until the next iteration of the event loop, so I/O and timers are processed before
+/// the co::thread is resumed. current_thread_on_resume() should be called on resume
+void yield_thread(thread_storage* thread, std::coroutine_handle<> awaiting_coroutine) noexcept;
 
-    return storage;
+inline void init_thread_storage(thread_storage& storage,
+                                const std::string& thread_name,
+                                uint64_t id,
+                                co::priority priority_class,
+                                scheduler* scheduler_ptr)
+{
+    storage.id = id;
+    storage.name = thread_name;
+    storage.priority_class = priority_class;
+    CO_DCHECK(scheduler_ptr != nullptr);
+    storage.scheduler_ptr = scheduler_ptr;
 }
 
 inline thread_storage** this_thread_storage()
@@ -66,6 +107,7 @@ inline void current_thread_on_suspend(std::coroutine_handle<> awaiting_coroutine
     CO_DCHECK(thread != nullptr);
     CO_DCHECK(thread->suspended_coroutine.address() == nullptr);
     thread->suspended_coroutine = awaiting_coroutine;
+    thread->budget_used = 0;
     *this_thread_storage() = nullptr;
 }
 
@@ -92,4 +134,33 @@ inline thread_storage& this_thread_storage_ref() noexcept
     return *ptr;
 }
 
+/// \brief awaiter of co::this_thread::yield()
+class [[nodiscard("co_await me")]] yield_awaiter
+{
+public:
+    yield_awaiter()
+        : _thread_storage(get_this_thread_storage_ptr())
+    {
+        CO_CHECK(_thread_storage != nullptr) << "The async code can't be run outside of co::loop";
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept
+    {
+        yield_thread(_thread_storage, awaiting_coroutine);
+    }
+
+    void await_resume() noexcept
+    {
+        current_thread_on_resume(_thread_storage);
+    }
+
+private:
+    thread_storage* _thread_storage = nullptr;
+};
+
 }  // namespace co::impl
\ No newline at end of file
@@ -1,84 +1,31 @@
 #include <co/impl/timer.hpp>
 
-#include <string>
-#include <co/event.hpp>
+#include <co/check.hpp>
+#include <co/impl/scheduler.hpp>
+#include <co/impl/timer_wheel.hpp>
 
 namespace co::impl
 {
 
-co::func<void> timer::close()
+void timer::set_timer(std::chrono::nanoseconds timeout, timer::callback cb, void* data)
 {
-    CO_DCHECK(_uv_timer_opt.has_value());
-    CO_DCHECK(uv_is_active((uv_handle_t*)&(*_uv_timer_opt)) == 0 /*inactive*/);
-    CO_DCHECK(_cb == nullptr);
-    CO_DCHECK(_data == nullptr);
-
-    event ev;
-
-    _uv_timer_opt->data = static_cast<void*>(&ev);
-    auto on_close = [](uv_handle_t* uv_timer)
-    {
-        CO_DCHECK(uv_timer != nullptr);
-        CO_DCHECK(uv_timer->data != nullptr);
-
-        auto& ev = *static_cast<event*>(uv_timer->data);
-        ev.notify();
-    };
-
-    uv_close((uv_handle_t*)&(*_uv_timer_opt), on_close);
-
-    co_await ev.wait();
-
-    // timer handle is closed now
-    _uv_timer_opt = std::nullopt;
-}
-
-void timer::init(uv_loop_t* uv_loop)
-{
-    CO_DCHECK(!_uv_timer_opt.has_value());
-
-    _uv_timer_opt = uv_timer_t{};
-    int res = uv_timer_init(uv_loop, &(*_uv_timer_opt));
-    using namespace std::string_literals;
-    if (res != 0)
-        throw std::runtime_error("unable to init a timer:"s + uv_strerror(res));
-    _uv_timer_opt->data = static_cast<void*>(this);
-}
-
-void timer::set_timer(int64_t milliseconds, timer::callback cb, void* data)
-{
-    CO_DCHECK(_uv_timer_opt.has_value());
-    CO_DCHECK(_cb == nullptr);
-    CO_DCHECK(_data == nullptr);
+    CO_DCHECK(!is_active());
+    CO_DCHECK(cb != nullptr);
 
     _cb = cb;
     _data = data;
-    int res = uv_timer_start(&(*_uv_timer_opt), on_timer, milliseconds, 0);
-    using namespace std::string_literals;
-    if (res != 0)
-        throw std::runtime_error("can't set a timer:"s + uv_strerror(res));
+    auto& scheduler = get_scheduler();
+    if (scheduler.precise_time())
+        scheduler.update_time();
+    scheduler.timers().add(*this, timeout);
 }
 
-void timer::stop()
+void timer::stop() noexcept
 {
-    CO_DCHECK(_uv_timer_opt.has_value());
-    uv_timer_stop(&(*_uv_timer_opt));
+    if (_wheel != nullptr)
+        _wheel->remove(*this);
     _cb = nullptr;
     _data = nullptr;
 }
 
-void timer::on_timer(uv_timer_t* uv_timer)
-{
-    CO_DCHECK(uv_timer != nullptr);
-    CO_DCHECK(uv_timer->data != nullptr);
-
-    auto& self = *static_cast<timer*>(uv_timer->data);
-    CO_DCHECK(self._cb != nullptr);
-    CO_DCHECK(self._data != nullptr);
-
-    self._cb(self._data);
-    self._cb = nullptr;
-    self._data = nullptr;
-}
-
-}  // namespace co::impl
\ No newline at end of file
+}  // namespace co::impl
@@ -1,14 +1,22 @@
 #pragma once
 
-#include <optional>
-#include <co/func.hpp>
-#include <uv.h>
+#include <chrono>
+#include <cstdint>
+#include <co/impl/intrusive_list.hpp>
 
 namespace co::impl
 {
 
+class timer_wheel;
+
+/// \brief one shot timer armed in the timer wheel of the current scheduler
+///
+/// The timer should be set, stopped and destroyed in the OS thread where the scheduler runs. The callback is called
+/// from the event loop.
 class timer
 {
+    friend class timer_wheel;
+
 public:
     using callback = void (*)(void* data);
 
@@ -19,22 +27,29 @@ public:
     timer& operator=(const timer&) = delete;
     timer& operator=(timer&&) = delete;
 
-    void init(uv_loop_t* uv_loop);
+    ~timer()
+    {
+        stop();
+    }
 
-    void set_timer(int64_t milliseconds, callback cb, void* data);
+    void set_timer(std::chrono::nanoseconds timeout, callback cb, void* data);
 
     // NOTE: idempotent
-    void stop();
+    void stop() noexcept;
 
-    co::func<void> close();
-
-private:
-    static void on_timer(uv_timer_t* uv_timer);
+    [[nodiscard]] bool is_active() const noexcept
+    {
+        return _wheel != nullptr;
+    }
 
 private:
-    std::optional<uv_timer_t> _uv_timer_opt;
+    intrusive_list_hook _hook;
+    // the tick of the timer wheel when the timer expires
+    uint64_t _expires_at = 0;
     callback _cb = nullptr;
     void* _data = nullptr;
+    // not null while the timer is armed
+    timer_wheel* _wheel = nullptr;
 };
 
 }  // namespace co::impl
@@ -0,0 +1,276 @@
+#include <co/impl/timer_wheel.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <co/check.hpp>
+
+#if defined(__linux__)
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace co::impl
+{
+
+void timer_wheel::init(uv_loop_t* uv_loop)
+{
+    CO_DCHECK(_n_timers == 0);
+    _uv_loop = uv_loop;
+    using namespace std::string_literals;
+    if (high_resolution())
+    {
+#if defined(__linux__)
+        _timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (_timerfd < 0)
+            throw std::runtime_error("unable to create a timerfd:"s + std::strerror(errno));
+        int res = uv_poll_init(uv_loop, &_uv_poll, _timerfd);
+        if (res != 0)
+            throw std::runtime_error("unable to init a timerfd poll:"s + uv_strerror(res));
+        _uv_poll.data = static_cast<void*>(this);
+#endif
+    }
+    else
+    {
+        int res = uv_timer_init(uv_loop, &_uv_timer);
+        if (res != 0)
+            throw std::runtime_error("unable to init a timer:"s + uv_strerror(res));
+        _uv_timer.data = static_cast<void*>(this);
+    }
+    _driver_due = std::numeric_limits<uint64_t>::max();
+    _current = now() / _resolution;
+}
+
+void timer_wheel::close()
+{
+    CO_DCHECK(_n_timers == 0);
+    if (high_resolution())
+    {
+#if defined(__linux__)
+        // uv_close() stops polling the fd, so it can be closed right away
+        uv_close((uv_handle_t*)&_uv_poll, /*on_close*/ nullptr);
+        ::close(_timerfd);
+        _timerfd = -1;
+#endif
+    }
+    else
+    {
+        uv_close((uv_handle_t*)&_uv_timer, /*on_close*/ nullptr);
+    }
+    _uv_loop = nullptr;
+}
+
+void timer_wheel::set_resolution(std::chrono::nanoseconds resolution)
+{
+    CO_CHECK(_uv_loop == nullptr) << "timer resolution can't be changed while the event loop is running";
+    _resolution = static_cast<uint64_t>(std::max<int64_t>(resolution.count(), 1));
+#if !defined(__linux__)
+    _resolution = std::max(_resolution, default_resolution);
+#endif
+}
+
+uint64_t timer_wheel::now() const
+{
+    if (high_resolution())
+        return uv_hrtime();
+    return uv_now(_uv_loop) * default_resolution;
+}
+
+void timer_wheel::add(timer& t, std::chrono::nanoseconds timeout)
+{
+    CO_DCHECK(_uv_loop != nullptr);
+    CO_DCHECK(t._wheel == nullptr);
+
+    // ~146 years, protects the computations below from overflows
+    constexpr int64_t max_timeout = int64_t{ 1 } << 62;
+
+    const uint64_t now_ns = now();
+    if (_n_timers == 0)
+        _current = std::max(_current, now_ns / _resolution);
+
+    uint64_t expires_at = now_ns + static_cast<uint64_t>(std::clamp<int64_t>(timeout.count(), 0, max_timeout));
+    if (_slack != 0)
+        expires_at = (expires_at + _slack - 1) / _slack * _slack;
+    // never fire before the timeout, the ticks up to _current are already processed
+    t._expires_at = std::max((expires_at + _resolution - 1) / _resolution, _current + 1);
+    t._wheel = this;
+    _n_timers++;
+    insert(t);
+
+    if (t._expires_at < _driver_due)
+        schedule();
+}
+
+void timer_wheel::remove(timer& t) noexcept
+{
+    CO_DCHECK(t._wheel == this);
+    t._hook.unlink();
+    t._wheel = nullptr;
+    CO_DCHECK(_n_timers > 0);
+    // nothing to wait, let the event loop finish
+    if (--_n_timers == 0 && _driver_due != std::numeric_limits<uint64_t>::max())
+        stop_driver();
+}
+
+void timer_wheel::insert(timer& t)
+{
+    // NOTE: timers cascaded to the current tick go to the slot which is about to be processed
+    CO_DCHECK(t._expires_at >= _current);
+    const uint64_t delta = std::min(t._expires_at - _current, max_ticks);
+
+    uint64_t level = 0;
+    while (level + 1 < n_levels && delta >= (uint64_t{ 1 } << ((level + 1) * bits_per_level)))
+        level++;
+
+    _slots[level][slot_index(t._expires_at, level)].push_back(t);
+}
+
+void timer_wheel::advance(uint64_t now_tick)
+{
+    while (_current < now_tick)
+    {
+        // jump over the ticks without timers to fire or to cascade
+        const uint64_t due = next_due();
+        if (due > now_tick)
+        {
+            _current = now_tick;
+            break;
+        }
+        CO_DCHECK(due > _current);
+        const uint64_t tick = _current = due;
+
+        // cascade timers from upper levels when the lower level wraps around
+        for (uint64_t level = 1; level < n_levels; level++)
+        {
+            if (slot_index(tick, level - 1) != 0)
+                break;
+
+            timers_list cascaded;
+            cascaded.swap(_slots[level][slot_index(tick, level)]);
+            while (!cascaded.empty())
+            {
+                timer& t = cascaded.front();
+                cascaded.pop_front();
+                insert(t);
+            }
+        }
+
+        timers_list& expired = _slots[0][slot_index(tick, 0)];
+        while (!expired.empty())
+        {
+            timer& t = expired.front();
+            CO_DCHECK(t._expires_at <= tick);
+            expired.pop_front();
+            t._wheel = nullptr;
+            _n_timers--;
+
+            auto cb = t._cb;
+            auto data = t._data;
+            t._cb = nullptr;
+            t._data = nullptr;
+            // NOTE: the timer might be destroyed in the callback
+            cb(data);
+        }
+    }
+}
+
+uint64_t timer_wheel::next_due() const
+{
+    uint64_t due = std::numeric_limits<uint64_t>::max();
+    for (uint64_t level = 0; level < n_levels; level++)
+    {
+        const uint64_t shift = level * bits_per_level;
+        const uint64_t base = _current >> shift;
+        for (uint64_t offset = 1; offset <= slots_per_level; offset++)
+        {
+            if (!_slots[level][(base + offset) & (slots_per_level - 1)].empty())
+            {
+                due = std::min(due, (base + offset) << shift);
+                break;
+            }
+        }
+    }
+    return due;
+}
+
+void timer_wheel::schedule()
+{
+    if (_n_timers == 0)
+    {
+        stop_driver();
+        return;
+    }
+
+    const uint64_t due = next_due();
+    CO_DCHECK(due != std::numeric_limits<uint64_t>::max());
+    start_driver(due);
+}
+
+void timer_wheel::start_driver(uint64_t tick)
+{
+    _driver_due = tick;
+    const uint64_t due_ns = tick * _resolution;
+    if (high_resolution())
+    {
+#if defined(__linux__)
+        // uv_hrtime() is CLOCK_MONOTONIC, thus the due time is used as is
+        itimerspec spec{};
+        spec.it_value.tv_sec = static_cast<time_t>(due_ns / 1'000'000'000);
+        spec.it_value.tv_nsec = static_cast<long>(due_ns % 1'000'000'000);
+        timerfd_settime(_timerfd, TFD_TIMER_ABSTIME, &spec, nullptr);
+        if (uv_is_active((uv_handle_t*)&_uv_poll) == 0)
+            uv_poll_start(&_uv_poll, UV_READABLE, &timer_wheel::on_timerfd);
+#endif
+        return;
+    }
+
+    const uint64_t due_ms = (due_ns + default_resolution - 1) / default_resolution;
+    const uint64_t now_ms = uv_now(_uv_loop);
+    uv_timer_start(&_uv_timer, &timer_wheel::on_uv_timer, due_ms > now_ms ? due_ms - now_ms : 0, 0);
+}
+
+void timer_wheel::stop_driver()
+{
+    _driver_due = std::numeric_limits<uint64_t>::max();
+    if (high_resolution())
+    {
+#if defined(__linux__)
+        // zero it_value disarms the timerfd
+        itimerspec spec{};
+        timerfd_settime(_timerfd, 0, &spec, nullptr);
+        uv_poll_stop(&_uv_poll);
+#endif
+        return;
+    }
+    uv_timer_stop(&_uv_timer);
+}
+
+void timer_wheel::on_uv_timer(uv_timer_t* uv_timer)
+{
+    CO_DCHECK(uv_timer != nullptr);
+    CO_DCHECK(uv_timer->data != nullptr);
+
+    auto& self = *static_cast<timer_wheel*>(uv_timer->data);
+    self._driver_due = std::numeric_limits<uint64_t>::max();
+    self.advance(self.now() / self._resolution);
+    self.schedule();
+}
+
+void timer_wheel::on_timerfd(uv_poll_t* uv_poll, int /*status*/, int /*events*/)
+{
+    CO_DCHECK(uv_poll != nullptr);
+    CO_DCHECK(uv_poll->data != nullptr);
+
+    auto& self = *static_cast<timer_wheel*>(uv_poll->data);
+#if defined(__linux__)
+    // drain the expirations counter, the fd is non blocking
+    uint64_t expirations = 0;
+    [[maybe_unused]] auto n = ::read(self._timerfd, &expirations, sizeof(expirations));
+#endif
+    self._driver_due = std::numeric_limits<uint64_t>::max();
+    self.advance(self.now() / self._resolution);
+    self.schedule();
+}
+
+}  // namespace co::impl
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <co/impl/intrusive_list.hpp>
+#include <co/impl/timer.hpp>
+#include <uv.h>
+
+namespace co::impl
+{
+
+/// \brief hierarchical timing wheel of the scheduler. Arming and cancelling a timer are O(1)
+///
+/// The time of the wheel is the event loop time in nanoseconds (uv_hrtime() base). The time is split into ticks of the
+/// resolution length, 1 millisecond by default. Level i of the wheel has 64 slots, each one covers 64^i ticks. Timers
+/// of upper levels are moved to lower levels when the wheel reaches their slot (cascading).
+///
+/// The wheel is driven by a single timer which is due to the next non empty slot. The millisecond resolution uses an
+/// uv timer and the cached loop time (uv_now). A sub-millisecond resolution uses a timerfd (CLOCK_MONOTONIC) polled by
+/// the event loop and reads the monotonic clock on each timer arming. timerfd is Linux only, other platforms always use
+/// the millisecond resolution.
+class timer_wheel
+{
+    using timers_list = intrusive_list<timer, &timer::_hook>;
+
+public:
+    static constexpr uint64_t bits_per_level = 6;
+    static constexpr uint64_t slots_per_level = uint64_t{ 1 } << bits_per_level;
+    static constexpr uint64_t n_levels = 6;
+    // timers expiring further in the future are parked at the top level and rearmed when their slot is reached
+    static constexpr uint64_t max_ticks = (uint64_t{ 1 } << (bits_per_level * n_levels)) - 1;
+    static constexpr uint64_t default_resolution = 1'000'000;  // 1ms
+
+    timer_wheel() = default;
+
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel(timer_wheel&&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+    timer_wheel& operator=(timer_wheel&&) = delete;
+
+    void init(uv_loop_t* uv_loop);
+
+    /// \brief closes the driving timer. Should be called when there are no armed timers
+    void close();
+
+    /// \brief arms the timer to be fired in timeout
+    void add(timer& t, std::chrono::nanoseconds timeout);
+
+    /// \brief disarms the timer
+    void remove(timer& t) noexcept;
+
+    /// \brief sets the coalescing slack. Timers are rounded up to be expired at the multiple of slack, thus close
+    /// timers are fired in one wake up. 0 (the default) means no coalescing
+    void set_slack(std::chrono::nanoseconds slack)
+    {
+        _slack = slack.count() > 0 ? static_cast<uint64_t>(slack.count()) : 0;
+    }
+
+    /// \brief sets the length of the tick. Should be called before init(). Resolutions below 1 millisecond switch the
+    /// wheel to the timerfd driver (on Linux only)
+    void set_resolution(std::chrono::nanoseconds resolution);
+
+    /// \brief returns true if the wheel is driven by timerfd
+    [[nodiscard]] bool high_resolution() const noexcept
+    {
+        return _resolution < default_resolution;
+    }
+
+    /// \brief get the number of armed timers
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _n_timers;
+    }
+
+private:
+    /// \brief get the current time of the wheel in nanoseconds
+    [[nodiscard]] uint64_t now() const;
+
+    void insert(timer& t);
+
+    /// \brief processes all the ticks up to now and fires expired timers
+    void advance(uint64_t now_tick);
+
+    /// \brief returns the nearest tick when some timers might be fired or cascaded
+    [[nodiscard]] uint64_t next_due() const;
+
+    /// \brief (re)starts the driving timer to be due to the next non empty slot
+    void schedule();
+
+    /// \brief starts the driving timer to fire at the beginning of the tick
+    void start_driver(uint64_t tick);
+
+    void stop_driver();
+
+    static void on_uv_timer(uv_timer_t* uv_timer);
+
+    static void on_timerfd(uv_poll_t* uv_poll, int status, int events);
+
+    static uint64_t slot_index(uint64_t tick, uint64_t level)
+    {
+        return (tick >> (level * bits_per_level)) & (slots_per_level - 1);
+    }
+
+private:
+    uv_loop_t* _uv_loop = nullptr;
+    uv_timer_t _uv_timer;
+    // used by the high resolution driver only
+    uv_poll_t _uv_poll;
+    int _timerfd = -1;
+    // the tick when the driving timer is due, max if the driving timer is stopped
+    uint64_t _driver_due = std::numeric_limits<uint64_t>::max();
+    // all the ticks up to _current (inclusive) are processed
+    uint64_t _current = 0;
+    // the length of the tick in nanoseconds
+    uint64_t _resolution = default_resolution;
+    uint64_t _slack = 0;
+    size_t _n_timers = 0;
+    std::array<std::array<timers_list, slots_per_level>, n_levels> _slots;
+};
+
+}  // namespace co::impl
@@ -12,10 +12,15 @@ namespace co::impl
 template <bool ThreadSafe>
 class waiting_queue_base;
 
+template <bool ThreadSafe, typename Lock, bool Interruptible>
+class waiting_queue_awaiter;
+
 template <bool ThreadSafe>
 class waker
 {
     friend class waiting_queue_base<ThreadSafe>;
+    template <bool, typename, bool>
+    friend class waiting_queue_awaiter;
 
 public:
     waker() = default;
@@ -30,6 +35,79 @@ private:
     intrusive_list_hook hook;
 };
 
+/// \brief stands for an absent external mutex in waiting_queue_awaiter
+struct no_lock
+{
+    void lock() noexcept
+    {}
+
+    void unlock() noexcept
+    {}
+};
+
+/// \brief awaits a notification of waiting_queue_base. The waker is embedded into the awaiter, thus waiting doesn't
+/// allocate
+///
+/// The waker is linked to the queue and the external lock is released right before the co::thread is suspended. The
+/// lock is reacquired when the co::thread is resumed.
+template <bool ThreadSafe, typename Lock, bool Interruptible>
+class [[nodiscard("co_await me")]] waiting_queue_awaiter
+{
+    using lock_ref = std::conditional_t<std::is_same_v<Lock, no_lock>, no_lock, Lock&>;
+    using event_awaiter_type = std::conditional_t<Interruptible,
+                                                  interruptible_event_awaiter<ThreadSafe>,
+                                                  event_awaiter<ThreadSafe>>;
+    using result_type = std::conditional_t<Interruptible, co::result<void>, void>;
+
+public:
+    waiting_queue_awaiter(waiting_queue_base<ThreadSafe>& queue, lock_ref lk) requires(!Interruptible)
+        : _queue(queue)
+        , _lk(lk)
+        , _event_awaiter(_waker._event)
+    {}
+
+    waiting_queue_awaiter(waiting_queue_base<ThreadSafe>& queue, lock_ref lk, const co::until& until) requires(
+        Interruptible)
+        : _queue(queue)
+        , _lk(lk)
+        , _event_awaiter(_waker._event, until)
+    {}
+
+    waiting_queue_awaiter& operator=(const waiting_queue_awaiter&) = delete;
+    waiting_queue_awaiter& operator=(waiting_queue_awaiter&&) = delete;
+    waiting_queue_awaiter(waiting_queue_awaiter&&) = delete;
+    waiting_queue_awaiter(const waiting_queue_awaiter&) = delete;
+
+    bool await_ready() const noexcept
+    {
+        // NOTE: the waker should be linked under the lock, thus go to await_suspend anyway
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept
+    {
+        _queue._wakers_list.push_back(_waker);
+        _lk.unlock();
+        if (_event_awaiter.await_ready())
+            return false;
+        return _event_awaiter.await_suspend(awaiting_coroutine);
+    }
+
+    result_type await_resume()
+    {
+        _lk.lock();
+        if (_waker.hook.is_linked())
+            _waker.hook.unlink();
+        return _event_awaiter.await_resume();
+    }
+
+private:
+    waiting_queue_base<ThreadSafe>& _queue;
+    lock_ref _lk;
+    waker<ThreadSafe> _waker;
+    event_awaiter_type _event_awaiter;
+};
+
 // NOTE: The thread-safe versions of waiting_queue is guarded by an external mutex.
 // The external mutex is passed to the corresponding class methods.
 // The notification methods must be called under the same mutex.
@@ -37,6 +115,8 @@ template <bool ThreadSafe>
 class waiting_queue_base
 {
     using wakers_list = intrusive_list<waker<ThreadSafe>, &waker<ThreadSafe>::hook>;
+    template <bool, typename, bool>
+    friend class waiting_queue_awaiter;
 
 public:
     waiting_queue_base() = default;
@@ -50,53 +130,30 @@ public:
     waiting_queue_base& operator=(waiting_queue_base&&) = default;
 
     /// \brief unconditionally waits until been notified
-    co::func<void> wait() requires(!ThreadSafe)
+    waiting_queue_awaiter<ThreadSafe, no_lock, false> wait() requires(!ThreadSafe)
     {
-        waker<ThreadSafe> w;
-        _wakers_list.push_back(w);
-        co_await w._event.wait();
-        if (w.hook.is_linked())
-            w.hook.unlink();
+        return { *this, no_lock{} };
     }
 
     template <typename Mutex>
-    co::func<void> wait(std::unique_lock<Mutex>& lk)
+    waiting_queue_awaiter<ThreadSafe, std::unique_lock<Mutex>, false> wait(std::unique_lock<Mutex>& lk)
     {
         CO_DCHECK(lk.owns_lock());
-        waker<ThreadSafe> w;
-        _wakers_list.push_back(w);
-        lk.unlock();
-        // TODO: add random sleep here for data race tests
-        co_await w._event.wait();
-        lk.lock();
-        if (w.hook.is_linked())
-            w.hook.unlink();
+        return { *this, lk };
     }
 
     /// \brief waits until been notified or interruption occurs based on until object
-    co::func<co::result<void>> wait(const co::until& until) requires(!ThreadSafe)
+    waiting_queue_awaiter<ThreadSafe, no_lock, true> wait(const co::until& until) requires(!ThreadSafe)
     {
-        waker<ThreadSafe> w;
-        _wakers_list.push_back(w);
-        auto status = co_await w._event.wait(until);
-        if (w.hook.is_linked())
-            w.hook.unlink();
-        co_return status;
+        return { *this, no_lock{}, until };
     }
 
     template <typename Mutex>
-    co::func<co::result<void>> wait(std::unique_lock<Mutex>& lk,
-                                    const co::until& until)
+    waiting_queue_awaiter<ThreadSafe, std::unique_lock<Mutex>, true> wait(std::unique_lock<Mutex>& lk,
+                                                                          const co::until& until)
     {
         CO_DCHECK(lk.owns_lock());
-        waker<ThreadSafe> w;
-        _wakers_list.push_back(w);
-        lk.unlock();
-        auto status = co_await w._event.wait(until);
-        lk.lock();
-        if (w.hook.is_linked())
-            w.hook.unlink();
-        co_return status;
+        return { *this, lk, until };
     }
 
     // Blocks the current std::thread until the waker is notified.
@@ -1,7 +1,11 @@
 #pragma once
 #include <co/func.hpp>
+#include <co/loop_clock.hpp>
+#include <co/loop_stats.hpp>
+#include <co/impl/frame_allocator.hpp>
 #include <co/thread.hpp>
 #include <co/impl/scheduler.hpp>
+#include <co/impl/scheduler_group.hpp>
 
 namespace co
 {
@@ -27,4 +31,112 @@ inline void loop(func<void>&& func)
     loop();
 }
 
+/// \brief schedules f as a main co::thread and runs n_workers event loops in separate OS threads until all
+/// co::threads will be done
+///
+/// The current OS thread is used as the first worker. An idle worker steals not yet started co::threads from busy
+/// workers, so a new co::thread might be run by any worker. Once started, the co::thread stays in its worker.
+/// co::threads that might run in different workers should communicate with thread safe primitives only (co::ts_event,
+/// co::ts_channel).
+///
+/// Usage:
+/// \code
+///     co::loop(std::thread::hardware_concurrency(), []() -> co::func<void>
+///     {
+///         for (int i = 0; i < 100; i++)
+///             co::thread(handle_request(i)).detach();
+///         co_return;
+///     });
+/// \endcode
+template <FuncLambdaConcept F>
+inline void loop(size_t n_workers, F&& f)
+{
+    impl::scheduler_group group(n_workers, /*work_stealing=*/true);
+    group.run([&f]() { co::thread(std::forward<F>(f), "main").detach(); });
+}
+
+/// \brief schedules func as a main co::thread and runs n_workers event loops in separate OS threads until all
+/// co::threads will be done
+inline void loop(size_t n_workers, func<void>&& func)
+{
+    impl::scheduler_group group(n_workers, /*work_stealing=*/true);
+    group.run([&func]() { co::thread(std::move(func), "main").detach(); });
+}
+
+/// \brief get statistics of the coroutine frame allocator of the event loop running in the current OS thread
+///
+/// The statistics are accumulated during the lifetime of the OS thread.
+inline frame_allocator_stats get_frame_allocator_stats()
+{
+    return impl::get_frame_allocator().stats();
+}
+
+/// \brief get a snapshot of the statistics of the event loop running in the current OS thread
+///
+/// The statistics are accumulated during the lifetime of the OS thread. To watch the event loop from another OS
+/// thread, see co::loop_group::stats().
+///
+/// Usage:
+/// \code
+///     const auto stats = co::get_loop_stats();
+///     if (stats.loop_lag.percentile(0.99) > std::chrono::nanoseconds(10ms).count())
+///         std::cerr << "the event loop is saturated\n";
+/// \endcode
+inline loop_stats get_loop_stats()
+{
+    return impl::get_scheduler().stats();
+}
+
+/// \brief sets the timer coalescing slack of the event loop of the current OS thread
+///
+/// Timeouts are rounded up to the multiple of the slack, thus timers expiring close to each other are fired in one
+/// wake up of the event loop. Zero slack (the default) means no coalescing. Can be called before co::loop().
+template <class Rep, class Period>
+inline void set_timer_slack(std::chrono::duration<Rep, Period> slack)
+{
+    impl::get_scheduler().timers().set_slack(std::chrono::ceil<std::chrono::nanoseconds>(slack));
+}
+
+/// \brief sets the timer resolution of the event loop of the current OS thread. Should be called before co::loop()
+///
+/// The default resolution is 1 millisecond, the timers are driven by an uv timer. A resolution below 1 millisecond
+/// (e.g. 10us) drives the timers with a timerfd (Linux only, ignored on other platforms), so co::this_thread::sleep_for
+/// and timeouts of co::until are precise up to the resolution. The high resolution timers read the monotonic clock on
+/// each timer arming and co::loop_clock::now() call.
+template <class Rep, class Period>
+inline void set_timer_resolution(std::chrono::duration<Rep, Period> resolution)
+{
+    impl::get_scheduler().timers().set_resolution(std::chrono::ceil<std::chrono::nanoseconds>(resolution));
+}
+
+/// \brief sets the number of operations (ready channel pushes and pops, mutex locks, event waits) a co::thread can
+/// complete without suspension before it's forced to yield to the event loop
+///
+/// Keeps I/O and timers responsive when a co::thread never has to wait. 0 means no limit, the default is 128. Can be
+/// called before co::loop().
+inline void set_thread_budget(uint32_t budget)
+{
+    impl::get_scheduler().set_thread_budget(budget);
+}
+
+/// \brief sets how many ready co::threads of each priority class are resumed in a round when all the classes have
+/// ready co::threads. The default is 8 high, 4 normal, 1 low
+///
+/// A class with zero weight is served only when the weighted classes have no ready co::threads, e.g.
+/// set_priority_weights(1, 0, 0) gives strict priority. Can be called before co::loop().
+inline void set_priority_weights(uint32_t high, uint32_t normal, uint32_t low)
+{
+    impl::get_scheduler().set_priority_weights({ high, normal, low });
+}
+
+/// \brief switches co::loop_clock of the event loop of the current OS thread to the precise mode
+///
+/// In the precise mode the time of the event loop is refreshed on every co::loop_clock::now() call and every timer
+/// arming (costs a clock read). By default the time is cached at the beginning of the loop iteration. Can be called
+/// before co::loop().
+inline void set_precise_loop_clock(bool precise)
+{
+    impl::get_scheduler().set_precise_time(precise);
+}
+
 }  // namespace co
\ No newline at end of file
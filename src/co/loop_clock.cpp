@@ -0,0 +1,24 @@
+#include <co/loop_clock.hpp>
+#include <co/impl/scheduler.hpp>
+
+namespace co
+{
+
+loop_clock::time_point loop_clock::now() noexcept
+{
+    auto& scheduler = impl::get_scheduler();
+    if (!scheduler.is_running())
+        return std::chrono::steady_clock::now();
+    return scheduler.now();
+}
+
+loop_clock::time_point loop_clock::update() noexcept
+{
+    auto& scheduler = impl::get_scheduler();
+    if (!scheduler.is_running())
+        return std::chrono::steady_clock::now();
+    scheduler.update_time();
+    return scheduler.now();
+}
+
+}  // namespace co
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+
+namespace co
+{
+
+/// \brief monotonic clock of the event loop running in the current OS thread
+///
+/// now() returns the time cached by the event loop at the beginning of the loop iteration (based on uv_now()), thus
+/// reading the time is cheap but might lag behind std::chrono::steady_clock by the time spent in the iteration. The
+/// cached time is refreshed with update(), or on every now() call if co::set_precise_loop_clock(true) is set.
+/// Outside of the event loop the clock falls back to std::chrono::steady_clock::now().
+///
+/// time_point is std::chrono::steady_clock::time_point, so both clocks can be mixed.
+struct loop_clock
+{
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::steady_clock::time_point;
+    static constexpr bool is_steady = true;
+
+    /// \brief get the cached time of the event loop
+    static time_point now() noexcept;
+
+    /// \brief refreshes the cached time of the event loop and returns it
+    static time_point update() noexcept;
+};
+
+}  // namespace co
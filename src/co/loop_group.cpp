@@ -0,0 +1,41 @@
+#include <co/loop_group.hpp>
+
+#include <co/check.hpp>
+
+namespace co
+{
+
+loop_group::loop_group(size_t n_shards, bool pin_threads)
+    : _group(n_shards, /*work_stealing=*/false, pin_threads)
+{
+    _group.start();
+}
+
+loop_group::~loop_group()
+{
+    if (!_joined)
+        join();
+}
+
+co::thread loop_group::spawn(size_t shard_id,
+                             func<void>&& func,
+                             const std::string& thread_name,
+                             co::priority priority)
+{
+    return co::thread(_group.worker(shard_id), std::move(func), thread_name, priority);
+}
+
+loop_stats loop_group::stats(size_t shard_id)
+{
+    CO_CHECK(!_joined) << "the group has been already joined";
+    return _group.worker(shard_id).stats();
+}
+
+void loop_group::join()
+{
+    CO_CHECK(!_joined) << "the group has been already joined";
+    _joined = true;
+    _group.join();
+}
+
+}  // namespace co
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <thread>
+#include <co/func.hpp>
+#include <co/loop_stats.hpp>
+#include <co/thread.hpp>
+#include <co/impl/scheduler_group.hpp>
+
+namespace co
+{
+
+/// \brief a group of "share nothing" event loops (shards), each one runs in its own OS thread
+///
+/// co::threads are spawned explicitly onto a shard and never migrate to another shard. By default each OS thread is
+/// pinned to a separate CPU core. co::threads of different shards should communicate with thread safe primitives
+/// only (co::ts_event, co::ts_channel).
+///
+/// Usage:
+/// \code
+///     co::loop_group group;  // one shard per CPU core
+///     co::ts_channel<request> requests(100);
+///     for (size_t shard = 0; shard < group.size(); shard++)
+///         group.spawn(shard, serve(requests)).detach();
+///     ...
+///     requests.close();
+///     group.join();  // waits until all co::threads of all shards will be finished
+/// \endcode
+class loop_group
+{
+public:
+    /// \brief starts n_shards event loops. If pin_threads is true, the i-th shard is pinned to the i-th CPU core the
+    /// process is allowed to run on. A shard which can't be pinned runs unpinned, see pinned_core()
+    explicit loop_group(size_t n_shards = std::max(1u, std::thread::hardware_concurrency()), bool pin_threads = true);
+
+    /// \brief joins the group if it's not joined yet
+    ~loop_group();
+
+    loop_group(const loop_group&) = delete;
+    loop_group(loop_group&&) = delete;
+    loop_group& operator=(const loop_group&) = delete;
+    loop_group& operator=(loop_group&&) = delete;
+
+    /// \brief get the number of shards in the group
+    [[nodiscard]] size_t size() const
+    {
+        return _group.size();
+    }
+
+    /// \brief get the CPU core the shard is pinned to, std::nullopt if pin_threads is false or the shard couldn't be
+    /// pinned
+    [[nodiscard]] std::optional<size_t> pinned_core(size_t shard_id) const
+    {
+        return _group.pinned_core(shard_id);
+    }
+
+    /// \brief schedules f as a new co::thread on the shard. Can be called from any OS thread
+    template <FuncLambdaConcept F>
+    co::thread spawn(size_t shard_id,
+                     F&& f,
+                     const std::string& thread_name = "",
+                     co::priority priority = co::priority::normal)
+    {
+        return co::thread(_group.worker(shard_id), std::forward<F>(f), thread_name, priority);
+    }
+
+    /// \brief schedules func as a new co::thread on the shard. Can be called from any OS thread
+    co::thread spawn(size_t shard_id,
+                     func<void>&& func,
+                     const std::string& thread_name = "",
+                     co::priority priority = co::priority::normal);
+
+    /// \brief get a snapshot of the statistics of the shard's event loop. Can be called from any OS thread until the
+    /// group is joined
+    [[nodiscard]] loop_stats stats(size_t shard_id);
+
+    /// \brief waits until all co::threads of all shards will be finished and stops the event loops
+    ///
+    /// No co::threads can be spawned from outside of the group after join() is called.
+    void join();
+
+    /// \brief get the shard id of the current OS thread, std::nullopt if it isn't a shard of a group
+    static std::optional<size_t> this_shard_id()
+    {
+        return impl::scheduler_group::current_worker_index();
+    }
+
+private:
+    impl::scheduler_group _group;
+    bool _joined = false;
+};
+
+}  // namespace co
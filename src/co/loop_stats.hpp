@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace co
+{
+
+/// \brief histogram with power of two buckets
+///
+/// The bucket i counts the values of the range [2^(i-1), 2^i), the bucket 0 counts zeros. The last bucket counts all
+/// the values above its lower bound.
+struct loop_histogram
+{
+    static constexpr size_t n_buckets = 40;
+
+    std::array<uint64_t, n_buckets> buckets{};
+    // number of recorded values
+    uint64_t count = 0;
+    // sum of recorded values
+    uint64_t sum = 0;
+    // the largest recorded value
+    uint64_t max = 0;
+
+    [[nodiscard]] double mean() const noexcept
+    {
+        return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+    }
+
+    /// \brief get the upper bound of the bucket where the q-quantile (0 <= q <= 1) falls, 0 if nothing is recorded
+    [[nodiscard]] uint64_t percentile(double q) const noexcept
+    {
+        if (count == 0)
+            return 0;
+        const auto rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < n_buckets; i++)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+                return i + 1 < n_buckets ? std::min(max, (uint64_t(1) << i) - 1) : max;
+        }
+        return max;
+    }
+};
+
+/// \brief statistics of an event loop, see co::get_loop_stats() and co::loop_group::stats()
+///
+/// The statistics are accumulated during the lifetime of the OS thread running the event loop. Durations are in
+/// nanoseconds.
+struct loop_stats
+{
+    // number of event loop iterations
+    uint64_t iterations = 0;
+    // number of co::threads started by the event loop
+    uint64_t threads_started = 0;
+    // number of co::threads finished in the event loop
+    uint64_t threads_finished = 0;
+    // number of co::threads started and not finished yet
+    uint64_t threads_alive = 0;
+    // number of times co::threads were resumed
+    uint64_t resumes = 0;
+    // number of co::threads woken up from other OS threads
+    uint64_t remote_wakeups = 0;
+    // number of ready co::threads at the beginning of each iteration
+    loop_histogram ready_depth;
+    // time spent resuming ready co::threads in each iteration
+    loop_histogram drain_time;
+    // time the event loop was blocked waiting for I/O and timers in each iteration
+    loop_histogram poll_time;
+    // duration of each iteration without the poll time. The event loop can't react to new events during this time,
+    // so the lag close to the timeouts or the request latency budget means the event loop is saturated
+    loop_histogram loop_lag;
+};
+
+}  // namespace co
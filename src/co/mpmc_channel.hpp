@@ -0,0 +1,541 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+
+#include <co/check.hpp>
+#include <co/impl/cache_line.hpp>
+#include <co/impl/waiting_queue.hpp>
+#include <co/status_codes.hpp>
+#include <co/until.hpp>
+
+namespace co::impl
+{
+
+// how many times an OS thread rechecks the channel before it's parked in blocking_push/blocking_pop
+inline constexpr size_t mpmc_spin_count = 16;
+
+/// \brief yields the OS thread until `ready` returns true, gives up after mpmc_spin_count attempts
+template <typename Ready>
+bool spin_until(Ready& ready)
+{
+    for (size_t i = 0; i < mpmc_spin_count; i++)
+    {
+        if (ready())
+            return true;
+        std::this_thread::yield();
+    }
+    return false;
+}
+
+/// \brief lock free bounded ring buffer with many producers and many consumers
+///
+/// Producers claim positions by advancing the tail, consumers by advancing the head, positions only grow. The slot of
+/// a position is position % capacity and it's reused once per lap = position / capacity. Each slot has a turn counter
+/// which says who owns the slot: the producer of lap L waits for turn 2 * L, the consumer of lap L waits for turn
+/// 2 * L + 1. The owner publishes the next turn when it's done with the slot. Thus the ring works with any capacity,
+/// including 1.
+///
+/// The lowest bit of the tail word is the closed flag, the tail position is kept in the rest of the bits. A producer
+/// claims a position by a CAS of the tail word, so it either claims the position before the ring is closed or gets
+/// co::closed. A claimed position is always published, consumers report co::closed only when the head has reached the
+/// tail position of the closed ring.
+template <typename T>
+class mpmc_ring
+{
+    struct slot
+    {
+        std::atomic<size_t> turn = 0;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+public:
+    explicit mpmc_ring(size_t capacity)
+        : _capacity(capacity)
+        , _slots(std::make_unique<slot[]>(capacity))
+    {
+        CO_CHECK(capacity > 0) << "mpmc_channel capacity should be greater than 0";
+    }
+
+    mpmc_ring(const mpmc_ring&) = delete;
+    mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+    ~mpmc_ring()
+    {
+        const size_t tail = _tail.load(std::memory_order::relaxed) >> 1;
+        for (size_t pos = _head.load(std::memory_order::relaxed); pos != tail; pos++)
+            std::destroy_at(item(_slots[pos % _capacity]));
+    }
+
+    /// \brief the ring is closed if the returned tail word has the closed bit. The caller must wake up all consumers
+    /// then, one of them might be waiting for this item to find out the ring is drained
+    /// \return the tail word seen after the item has been published, co::full, co::closed
+    template <typename T2>
+    co::result<size_t> try_push(T2&& t)
+    {
+        size_t tail = _tail.load(std::memory_order::relaxed);
+        while (true)
+        {
+            if (tail & closed_bit)
+                return co::err(co::closed);
+            const size_t pos = tail >> 1;
+            slot& s = _slots[pos % _capacity];
+            const size_t turn = 2 * (pos / _capacity);
+            if (s.turn.load(std::memory_order::acquire) == turn)
+            {
+                // on failure the exchange reloads the tail, a concurrent close() fails it too
+                if (_tail.compare_exchange_weak(tail, tail + 2, std::memory_order::relaxed))
+                {
+                    std::construct_at(item(s), std::forward<T2>(t));
+                    s.turn.store(turn + 1, std::memory_order::release);
+                    std::atomic_thread_fence(std::memory_order::seq_cst);
+                    return co::ok(_tail.load(std::memory_order::relaxed));
+                }
+            }
+            else
+            {
+                // the slot isn't consumed yet. The ring is full unless other producers have moved the tail
+                const size_t prev_tail = tail;
+                tail = _tail.load(std::memory_order::relaxed);
+                if (tail == prev_tail)
+                    return co::err(co::full);
+            }
+        }
+    }
+
+    /// \return ok, co::empty, co::closed when the ring is closed and drained
+    co::result<void> try_pop(std::optional<T>& t)
+    {
+        size_t head = _head.load(std::memory_order::relaxed);
+        while (true)
+        {
+            slot& s = _slots[head % _capacity];
+            const size_t turn = 2 * (head / _capacity) + 1;
+            if (s.turn.load(std::memory_order::acquire) == turn)
+            {
+                if (_head.compare_exchange_weak(head, head + 1, std::memory_order::relaxed))
+                {
+                    T* ptr = item(s);
+                    t.emplace(std::move(*ptr));
+                    std::destroy_at(ptr);
+                    s.turn.store(turn + 1, std::memory_order::release);
+                    return co::ok();
+                }
+            }
+            else
+            {
+                const size_t prev_head = head;
+                head = _head.load(std::memory_order::relaxed);
+                if (head == prev_head)
+                {
+                    // a claimed position might be not published yet, the ring isn't drained then
+                    const size_t tail = _tail.load(std::memory_order::acquire);
+                    if ((tail & closed_bit) && (tail >> 1) == head)
+                        return co::err(co::closed);
+                    return co::err(co::empty);
+                }
+            }
+        }
+    }
+
+    /// \brief closes the ring, producers can't claim positions anymore
+    void close() noexcept
+    {
+        _tail.fetch_or(closed_bit, std::memory_order::seq_cst);
+    }
+
+    [[nodiscard]] bool is_closed() const noexcept
+    {
+        return (_tail.load(std::memory_order::acquire) & closed_bit) != 0;
+    }
+
+    /// \brief returns true if the ring is closed and all items have been popped
+    [[nodiscard]] bool is_drained() const noexcept
+    {
+        const size_t tail = _tail.load(std::memory_order::acquire);
+        return (tail & closed_bit) && (tail >> 1) == _head.load(std::memory_order::acquire);
+    }
+
+    /// \brief returns true if the slot at the tail is free. The result might be stale immediately
+    [[nodiscard]] bool can_push() const noexcept
+    {
+        const size_t tail = _tail.load(std::memory_order::acquire) >> 1;
+        return _slots[tail % _capacity].turn.load(std::memory_order::acquire) == 2 * (tail / _capacity);
+    }
+
+    /// \brief returns true if the slot at the head has an item. The result might be stale immediately
+    [[nodiscard]] bool can_pop() const noexcept
+    {
+        const size_t head = _head.load(std::memory_order::acquire);
+        return _slots[head % _capacity].turn.load(std::memory_order::acquire) == 2 * (head / _capacity) + 1;
+    }
+
+    static constexpr size_t closed_bit = 1;
+
+private:
+    static T* item(slot& s) noexcept
+    {
+        return std::launder(reinterpret_cast<T*>(s.storage));
+    }
+
+    const size_t _capacity;
+    std::unique_ptr<slot[]> _slots;
+
+    // consumers' position
+    alignas(cache_line_size) std::atomic<size_t> _head = 0;
+    // producers' position and the closed flag
+    alignas(cache_line_size) std::atomic<size_t> _tail = 0;
+};
+
+/// \brief waiters of one side of mpmc_channel, they are parked until the other side makes progress
+///
+/// The same protocol as spsc_parking, but several waiters can be parked at once. The number of parked waiters is
+/// raised under the mutex before a waiter rechecks the ring and waits. The other side puts a seq_cst fence after it
+/// updates the ring and takes the mutex only if somebody is parked, so the mutex isn't touched while the ring is
+/// neither full nor empty.
+struct mpmc_parking
+{
+    std::mutex mutex;
+    std::atomic<size_t> parked = 0;
+    ts_waiting_queue queue;
+
+    /// \brief wakes up one parked waiter if any. Called by the other side after it has updated the ring
+    void unpark_one()
+    {
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (parked.load(std::memory_order::relaxed) == 0)
+            return;
+        std::unique_lock lk(mutex);
+        queue.notify_one();
+    }
+
+    /// \brief wakes up all parked waiters
+    void unpark_all()
+    {
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (parked.load(std::memory_order::relaxed) == 0)
+            return;
+        std::unique_lock lk(mutex);
+        queue.notify_all();
+    }
+};
+
+template <typename T>
+struct mpmc_channel_shared_state
+{
+    explicit mpmc_channel_shared_state(size_t capacity)
+        : ring(capacity)
+    {}
+
+    mpmc_ring<T> ring;
+    alignas(cache_line_size) mpmc_parking producers;
+    alignas(cache_line_size) mpmc_parking consumers;
+};
+
+}  // namespace co::impl
+
+namespace co
+{
+
+/// \brief buffered channel to pass data of type T between many producers and many consumers in different OS threads
+///
+/// A drop-in replacement of co::ts_channel: it has the same interface and semantics, but the items are kept in a lock
+/// free ring buffer. Producers and consumers don't take a mutex while the channel is neither full nor empty, a mutex
+/// is taken only to park a waiter when the channel is full (empty) and to wake parked waiters up.
+///
+/// A push either puts the value into the channel or returns co::closed, even when it races with close().
+///
+/// mpmc_channel owns a count referenced data inside. Thus it's cheap to copy a mpmc_channel.
+/// Usage:
+/// \code
+///     co::mpmc_channel<int> ch(1024);
+///
+///     std::vector<std::thread> producers;
+///     for (int p = 0; p < 4; p++)
+///         producers.emplace_back([ch]() mutable {
+///             for (int i = 0; i < 100; i++)
+///                 ch.blocking_push(i).unwrap();
+///         });
+///
+///     co::loop([ch]() mutable -> co::func<void> {
+///         for (int i = 0; i < 400; i++)
+///             (co_await ch.pop()).unwrap();
+///     });
+///     for (auto& producer : producers)
+///         producer.join();
+/// \endcode
+template <typename T>
+class mpmc_channel
+{
+public:
+    /// \brief create a new channel with capacity
+    explicit mpmc_channel(size_t capacity)
+        : _state(std::make_shared<impl::mpmc_channel_shared_state<T>>(capacity))
+    {}
+
+    /// \brief pushes a new value to the channel. Returns co::full if the channel is full
+    /// \return ok, co::full, co::close
+    template <typename T2>
+    co::result<void> try_push(T2&& t) requires(std::is_constructible_v<T, T2>);
+
+    /// \brief pushes a new value to the channel. Blocks until the channel has space or is interrupted
+    /// \return ok, co::close, co::cancel, co::timeout
+    template <typename T2>
+    co::func<co::result<void>> push(T2&& t, co::until until = {}) requires(std::is_constructible_v<T, T2>);
+
+    /// \brief the blocking version of push(). Blocks the current OS thread until the channel has space or is closed
+    template <typename T2>
+    co::result<void> blocking_push(T2&& t) requires(std::is_constructible_v<T, T2>);
+
+    /// \brief the blocking version of push(). Blocks the current OS thread until the channel has space, is closed or
+    /// timeout has occurred
+    template <typename T2, typename Rep, typename Period>
+    co::result<void> blocking_push(T2&& t,
+                                   std::chrono::duration<Rep, Period> timeout) requires(std::is_constructible_v<T, T2>);
+
+    /// \brief pop the front value from the channel or returns co::empty
+    /// \return ok, co::empty, co::close
+    co::result<T> try_pop();
+
+    /// \brief pop the front value from the channel. Blocks until the channel has some values or is interrupted
+    /// \return ok, co::close, co::cancel, co::timeout
+    co::func<co::result<T>> pop(co::until until = {});
+
+    /// \brief the blocking version of pop(). Blocks the current OS thread until the channel has a value or is closed
+    co::result<T> blocking_pop();
+
+    /// \brief the blocking version of pop(). Blocks the current OS thread until the channel has a value, is closed or
+    /// timeout has occurred
+    template <typename Rep, typename Period>
+    co::result<T> blocking_pop(std::chrono::duration<Rep, Period> timeout);
+
+    /// \brief closes the channel. Pop operations will return co::closed after drained last elements
+    void close();
+
+    /// \brief returns true if the channel is closed
+    [[nodiscard]] bool is_closed() const;
+
+private:
+    void check_shared_state() const
+    {
+        CO_CHECK(_state != nullptr) << "Propbably you are trying to use the channel after a move.";
+    }
+
+    /// \brief parks the current co::thread until `ready` might have become true
+    template <typename Ready>
+    static co::func<co::result<void>> wait(impl::mpmc_parking& parking, Ready ready, const co::until& until);
+
+    /// \brief parks the current OS thread until `ready` might have become true
+    template <typename Ready, typename Rep, typename Period>
+    static co::result<void> blocking_wait(impl::mpmc_parking& parking,
+                                          Ready&& ready,
+                                          std::chrono::duration<Rep, Period> timeout);
+
+    /// \brief wakes up the consumers after an item has been published
+    void unpark_consumers(size_t tail) const
+    {
+        if (tail & impl::mpmc_ring<T>::closed_bit)
+            _state->consumers.unpark_all();
+        else
+            _state->consumers.unpark_one();
+    }
+
+    [[nodiscard]] bool has_space_or_closed() const
+    {
+        return _state->ring.can_push() || _state->ring.is_closed();
+    }
+
+    [[nodiscard]] bool has_item_or_drained() const
+    {
+        return _state->ring.can_pop() || _state->ring.is_drained();
+    }
+
+    std::shared_ptr<impl::mpmc_channel_shared_state<T>> _state;
+};
+
+template <typename T>
+template <typename T2>
+co::result<void> mpmc_channel<T>::try_push(T2&& t) requires(std::is_constructible_v<T, T2>)
+{
+    check_shared_state();
+    auto res = _state->ring.try_push(std::forward<T2>(t));
+    if (res.is_err())
+        return res.err();
+    unpark_consumers(res.unwrap());
+    return co::ok();
+}
+
+template <typename T>
+template <typename T2>
+co::func<co::result<void>> mpmc_channel<T>::push(T2&& t, co::until until) requires(std::is_constructible_v<T, T2>)
+{
+    check_shared_state();
+    while (true)
+    {
+        auto res = _state->ring.try_push(std::forward<T2>(t));
+        if (res.is_ok())
+        {
+            unpark_consumers(res.unwrap());
+            break;
+        }
+        if (res == co::closed)
+            co_return res.err();
+        auto wait_res = co_await wait(
+            _state->producers, [this]() { return has_space_or_closed(); }, until);
+        if (wait_res.is_err())
+            co_return wait_res.err();
+    }
+    if (impl::consume_budget())
+        co_await impl::yield_awaiter{};
+    co_return co::ok();
+}
+
+template <typename T>
+template <typename T2>
+co::result<void> mpmc_channel<T>::blocking_push(T2&& t) requires(std::is_constructible_v<T, T2>)
+{
+    return blocking_push(std::forward<T2>(t), std::chrono::steady_clock::duration::max());
+}
+
+template <typename T>
+template <typename T2, typename Rep, typename Period>
+co::result<void> mpmc_channel<T>::blocking_push(T2&& t, std::chrono::duration<Rep, Period> timeout) requires(
+    std::is_constructible_v<T, T2>)
+{
+    check_shared_state();
+    while (true)
+    {
+        auto res = _state->ring.try_push(std::forward<T2>(t));
+        if (res.is_ok())
+        {
+            unpark_consumers(res.unwrap());
+            return co::ok();
+        }
+        if (res == co::closed)
+            return res.err();
+        // the consumers usually make progress soon, give them a chance before going to sleep
+        auto ready = [this]() { return has_space_or_closed(); };
+        if (impl::spin_until(ready))
+            continue;
+        auto wait_res = blocking_wait(_state->producers, ready, timeout);
+        if (wait_res.is_err())
+            return wait_res.err();
+    }
+}
+
+template <typename T>
+co::result<T> mpmc_channel<T>::try_pop()
+{
+    check_shared_state();
+    std::optional<T> item;
+    auto res = _state->ring.try_pop(item);
+    if (res.is_err())
+        return res.err();
+    _state->producers.unpark_one();
+    return co::ok(std::move(*item));
+}
+
+template <typename T>
+co::func<co::result<T>> mpmc_channel<T>::pop(co::until until)
+{
+    check_shared_state();
+    while (true)
+    {
+        auto res = try_pop();
+        if (res.is_ok())
+        {
+            if (impl::consume_budget())
+                co_await impl::yield_awaiter{};
+            co_return res;
+        }
+        if (res == co::closed)
+            co_return res;
+        auto wait_res = co_await wait(
+            _state->consumers, [this]() { return has_item_or_drained(); }, until);
+        if (wait_res.is_err())
+            co_return wait_res.err();
+    }
+}
+
+template <typename T>
+co::result<T> mpmc_channel<T>::blocking_pop()
+{
+    return blocking_pop(std::chrono::steady_clock::duration::max());
+}
+
+template <typename T>
+template <typename Rep, typename Period>
+co::result<T> mpmc_channel<T>::blocking_pop(std::chrono::duration<Rep, Period> timeout)
+{
+    check_shared_state();
+    while (true)
+    {
+        auto res = try_pop();
+        if (res.is_ok() || res == co::closed)
+            return res;
+        auto ready = [this]() { return has_item_or_drained(); };
+        if (impl::spin_until(ready))
+            continue;
+        auto wait_res = blocking_wait(_state->consumers, ready, timeout);
+        if (wait_res.is_err())
+            return wait_res.err();
+    }
+}
+
+template <typename T>
+void mpmc_channel<T>::close()
+{
+    check_shared_state();
+    _state->ring.close();
+    _state->producers.unpark_all();
+    _state->consumers.unpark_all();
+}
+
+template <typename T>
+bool mpmc_channel<T>::is_closed() const
+{
+    check_shared_state();
+    return _state->ring.is_closed();
+}
+
+template <typename T>
+template <typename Ready>
+co::func<co::result<void>> mpmc_channel<T>::wait(impl::mpmc_parking& parking, Ready ready, const co::until& until)
+{
+    std::unique_lock lk(parking.mutex);
+    parking.parked.fetch_add(1, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    co::result<void> res = co::ok();
+    if (!ready())
+        res = co_await parking.queue.wait(lk, until);
+    parking.parked.fetch_sub(1, std::memory_order::relaxed);
+    co_return res;
+}
+
+template <typename T>
+template <typename Ready, typename Rep, typename Period>
+co::result<void> mpmc_channel<T>::blocking_wait(impl::mpmc_parking& parking,
+                                                Ready&& ready,
+                                                std::chrono::duration<Rep, Period> timeout)
+{
+    std::unique_lock lk(parking.mutex);
+    parking.parked.fetch_add(1, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    co::result<void> res = co::ok();
+    if (!ready())
+    {
+        if (timeout == std::chrono::duration<Rep, Period>::max())
+            parking.queue.blocking_wait(lk);
+        else
+            res = parking.queue.blocking_wait(lk, timeout);
+    }
+    parking.parked.fetch_sub(1, std::memory_order::relaxed);
+    return res;
+}
+
+}  // namespace co
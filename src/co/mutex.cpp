@@ -3,23 +3,6 @@
 namespace co
 {
 
-co::func<void> mutex::lock()
-{
-    if (try_lock())
-        co_return;
-
-    co_await _waiting_queue.wait();
-}
-
-co::func<co::result<void>> mutex::lock(const until& until)
-{
-    // TODO: check stop token first?
-    if (try_lock())
-        co_return co::ok();
-
-    co_return co_await _waiting_queue.wait(until);
-}
-
 bool mutex::try_lock()
 {
     if (_is_locked)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <co/func.hpp>
 #include <co/impl/waiting_queue.hpp>
 #include <co/until.hpp>
@@ -32,9 +33,12 @@ namespace co
 /// \endcode
 class mutex
 {
+    class lock_awaiter;
+    class interruptible_lock_awaiter;
+
 public:
     /// \brief get the lock, if the lock is already taken lock() will suspend to wait the lock
-    co::func<void> lock();
+    lock_awaiter lock();
 
     /// \brief get the lock, if the lock is already taken lock() will suspend to wait the lock. The wait period is
     /// controlled by until parameter.
@@ -53,7 +57,7 @@ public:
     ///     auto res = co_await mtx.lock(100ms, co::this_thread::stop_token());
     ///     if (res.is_err()) std::cout << "timeout or cancelled\n";
     /// \endcode
-    co::func<co::result<void>> lock(const co::until& until);
+    interruptible_lock_awaiter lock(const co::until& until);
 
     /// \brief non blocking version of getting the lock. returns true in case of the lock is obtained
     bool try_lock();
@@ -81,4 +85,103 @@ private:
     impl::waiting_queue _waiting_queue;
 };
 
+// NOTE: unlock() passes the lock to the first waiter, so the waiter owns the lock when it's resumed
+class [[nodiscard("co_await me")]] mutex::lock_awaiter
+{
+public:
+    explicit lock_awaiter(mutex& mutex)
+        : _mutex(mutex)
+    {}
+
+    bool await_ready()
+    {
+        if (!_mutex.try_lock())
+            return false;
+        // the lock is taken, but the co::thread has exhausted its budget
+        if (impl::consume_budget())
+            _yield_awaiter.emplace();
+        return !_yield_awaiter.has_value();
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting_coroutine)
+    {
+        if (_yield_awaiter.has_value())
+        {
+            _yield_awaiter->await_suspend(awaiting_coroutine);
+            return true;
+        }
+        _wait_awaiter.emplace(_mutex._waiting_queue, impl::no_lock{});
+        return _wait_awaiter->await_suspend(awaiting_coroutine);
+    }
+
+    void await_resume()
+    {
+        if (_yield_awaiter.has_value())
+            _yield_awaiter->await_resume();
+        if (_wait_awaiter.has_value())
+            _wait_awaiter->await_resume();
+    }
+
+private:
+    mutex& _mutex;
+    std::optional<impl::waiting_queue_awaiter<false, impl::no_lock, false>> _wait_awaiter;
+    std::optional<impl::yield_awaiter> _yield_awaiter;
+};
+
+class [[nodiscard("co_await me")]] mutex::interruptible_lock_awaiter
+{
+public:
+    interruptible_lock_awaiter(mutex& mutex, co::until until)
+        : _mutex(mutex)
+        , _until(std::move(until))
+    {}
+
+    bool await_ready()
+    {
+        // TODO: check stop token first?
+        if (!_mutex.try_lock())
+            return false;
+        // the lock is taken, but the co::thread has exhausted its budget
+        if (impl::consume_budget())
+            _yield_awaiter.emplace();
+        return !_yield_awaiter.has_value();
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting_coroutine)
+    {
+        if (_yield_awaiter.has_value())
+        {
+            _yield_awaiter->await_suspend(awaiting_coroutine);
+            return true;
+        }
+        _wait_awaiter.emplace(_mutex._waiting_queue, impl::no_lock{}, _until);
+        return _wait_awaiter->await_suspend(awaiting_coroutine);
+    }
+
+    co::result<void> await_resume()
+    {
+        if (_yield_awaiter.has_value())
+            _yield_awaiter->await_resume();
+        if (!_wait_awaiter.has_value())
+            return co::ok();
+        return _wait_awaiter->await_resume();
+    }
+
+private:
+    mutex& _mutex;
+    co::until _until;
+    std::optional<impl::waiting_queue_awaiter<false, impl::no_lock, true>> _wait_awaiter;
+    std::optional<impl::yield_awaiter> _yield_awaiter;
+};
+
+inline mutex::lock_awaiter mutex::lock()
+{
+    return lock_awaiter(*this);
+}
+
+inline mutex::interruptible_lock_awaiter mutex::lock(const co::until& until)
+{
+    return interruptible_lock_awaiter(*this, until);
+}
+
 }  // namespace co
\ No newline at end of file
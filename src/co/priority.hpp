@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace co
+{
+
+/// \brief priority class of a co::thread
+///
+/// The scheduler keeps a ready queue per class. Ready co::threads of higher classes are resumed more often, see
+/// co::set_priority_weights().
+enum class priority : uint8_t
+{
+    high,
+    normal,
+    low
+};
+
+namespace impl
+{
+
+inline constexpr size_t n_priorities = 3;
+
+inline constexpr size_t priority_index(priority p)
+{
+    return static_cast<size_t>(p);
+}
+
+}  // namespace impl
+
+}  // namespace co
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <co/channel.hpp>
+#include <co/check.hpp>
+#include <co/event.hpp>
+#include <co/func.hpp>
+#include <co/result.hpp>
+#include <co/until.hpp>
+
+namespace co::impl
+{
+
+enum class select_status
+{
+    parked,  // the source is not ready, the wakeup event is registered in it
+    ready,   // the source is ready and the select has been won by it
+    missed   // the wakeup event has been already notified by another source
+};
+
+/// \brief receives a value of a channel in co::select. The value is moved to out, out is reset if the channel is closed
+/// and drained
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+class select_recv
+{
+public:
+    static constexpr bool thread_safe = ThreadSafe;
+
+    select_recv(channel_base<T, ThreadSafe, Queue, Overflow>& channel, std::optional<T>& out)
+        : _channel(channel)
+        , _out(out)
+    {
+        _channel.check_shared_state();
+    }
+
+    select_recv(const select_recv& other)
+        : _channel(other._channel)
+        , _out(other._out)
+    {
+        CO_DCHECK(!other._slot.hook.is_linked());
+    }
+
+    /// \brief takes the front value if any, parks the slot in the channel otherwise. The readiness check and the
+    /// parking are done under one lock, thus no value is missed in between
+    select_status poll_or_park(event_base<ThreadSafe>& wakeup)
+    {
+        auto& state = *_channel._state;
+        std::unique_lock lk(state._mutex);
+        if (state._queue.empty() && !state._closed)
+        {
+            _slot.value.reset();
+            _channel.park_consumer_locked(_slot, wakeup);
+            return select_status::parked;
+        }
+
+        // claim the select before taking the value, a producer may have handed a value over to an earlier source
+        if (!wakeup.notify())
+            return select_status::missed;
+        if (state._queue.empty())
+            _out.reset();
+        else
+            _out.emplace(_channel.pop_front_locked());
+        return select_status::ready;
+    }
+
+    /// \brief unparks the slot. Returns true if a producer has handed a value over to the slot, it's moved to out then
+    bool unpark()
+    {
+        auto& state = *_channel._state;
+        std::unique_lock lk(state._mutex);
+        _channel.unpark_consumer_locked(_slot);
+        if (!_slot.value)
+            return false;
+        _out.emplace(std::move(*_slot.value));
+        _slot.value.reset();
+        return true;
+    }
+
+private:
+    channel_base<T, ThreadSafe, Queue, Overflow>& _channel;
+    std::optional<T>& _out;
+    handoff_slot<T, ThreadSafe> _slot;
+};
+
+/// \brief waits for an event in co::select. The event isn't reset, it stays notified after the select
+template <bool ThreadSafe>
+class select_event
+{
+public:
+    static constexpr bool thread_safe = ThreadSafe;
+
+    explicit select_event(event_base<ThreadSafe>& event)
+        : _event(event)
+    {}
+
+    select_event(const select_event& other)
+        : _event(other._event)
+    {
+        CO_DCHECK(!other._link);
+    }
+
+    select_status poll_or_park(event_base<ThreadSafe>& wakeup)
+    {
+        CO_DCHECK(!_link);
+        if (!_event.is_notified())
+        {
+            _link.emplace(wakeup);
+            if (_link->attach(_event))
+                return select_status::parked;
+            _link.reset();
+            // an interrupted event will never be notified, wait for the other sources
+            if (!_event.is_notified())
+                return select_status::parked;
+        }
+        return wakeup.notify() ? select_status::ready : select_status::missed;
+    }
+
+    bool unpark()
+    {
+        if (_link)
+        {
+            _link->detach();
+            _link.reset();
+        }
+        // the notification of the event is picked up by the next poll
+        return false;
+    }
+
+private:
+    event_base<ThreadSafe>& _event;
+    std::optional<event_link<ThreadSafe>> _link;
+};
+
+template <typename Source>
+struct select_case
+{
+    using type = std::remove_cvref_t<Source>;
+};
+
+template <bool ThreadSafe>
+struct select_case<event_base<ThreadSafe>&>
+{
+    using type = select_event<ThreadSafe>;
+};
+
+template <typename Source>
+using select_case_t = typename select_case<Source>::type;
+
+template <typename T>
+struct is_select_case : std::false_type
+{};
+
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+struct is_select_case<select_recv<T, ThreadSafe, Queue, Overflow>> : std::true_type
+{};
+
+template <bool ThreadSafe>
+struct is_select_case<select_event<ThreadSafe>> : std::true_type
+{};
+
+template <typename Source>
+concept select_source = is_select_case<select_case_t<Source>>::value;
+
+/// \brief polls the cases in order and parks the ones which are not ready. Stops at the first ready case. Returns the
+/// index of the ready case if the select has been won by it, n_parked is the number of cases to unpark
+template <bool ThreadSafe, typename... Cases>
+std::optional<size_t> select_poll_or_park(std::tuple<Cases...>& cases,
+                                          event_base<ThreadSafe>& wakeup,
+                                          size_t& n_parked)
+{
+    std::optional<size_t> ready;
+    bool stop = false;
+    n_parked = 0;
+    std::apply(
+        [&](auto&... c)
+        {
+            auto poll = [&](auto& source)
+            {
+                if (stop)
+                    return;
+                switch (source.poll_or_park(wakeup))
+                {
+                case select_status::parked:
+                    n_parked++;
+                    return;
+                case select_status::ready:
+                    ready = n_parked;
+                    break;
+                case select_status::missed:
+                    break;
+                }
+                stop = true;
+            };
+            (poll(c), ...);
+        },
+        cases);
+    return ready;
+}
+
+/// \brief unparks the first n_parked cases. Returns the index of the case which has got a value handed over
+template <typename... Cases>
+std::optional<size_t> select_unpark(std::tuple<Cases...>& cases, size_t n_parked)
+{
+    std::optional<size_t> handed_over;
+    size_t index = 0;
+    std::apply(
+        [&](auto&... c)
+        {
+            auto unpark = [&](auto& source)
+            {
+                if (index < n_parked && source.unpark())
+                {
+                    // the wakeup event is notified once, thus only one producer hands a value over
+                    CO_DCHECK(!handed_over);
+                    handed_over = index;
+                }
+                index++;
+            };
+            (unpark(c), ...);
+        },
+        cases);
+    return handed_over;
+}
+
+template <typename... Cases>
+co::func<co::result<size_t>> select(co::until until, std::tuple<Cases...> cases)
+{
+    static constexpr bool thread_safe = std::tuple_element_t<0, std::tuple<Cases...>>::thread_safe;
+    static_assert(((Cases::thread_safe == thread_safe) && ...),
+                  "co::select can't mix thread safe and not thread safe sources");
+
+    while (true)
+    {
+        // one-shot event shared by all the sources, the first notification wins the select
+        event_base<thread_safe> wakeup;
+        size_t n_parked = 0;
+        std::optional<size_t> ready = select_poll_or_park(cases, wakeup, n_parked);
+        co::result<void> res = co::ok();
+        if (!ready && n_parked == sizeof...(Cases))
+            res = co_await wakeup.wait(until);
+        std::optional<size_t> handed_over = select_unpark(cases, n_parked);
+        if (ready || handed_over)
+        {
+            if (consume_budget())
+                co_await yield_awaiter{};
+            co_return co::ok(ready ? *ready : *handed_over);
+        }
+        if (res.is_err())
+            co_return res.err();
+    }
+}
+
+}  // namespace co::impl
+
+namespace co
+{
+
+/// \brief a receive case of co::select. The popped value is moved to out, out is reset if the channel is closed and
+/// drained. The channel and out must outlive the select
+template <typename T, bool ThreadSafe, typename Queue, overflow_policy Overflow>
+impl::select_recv<T, ThreadSafe, Queue, Overflow> recv(channel_base<T, ThreadSafe, Queue, Overflow>& channel,
+                                                       std::optional<T>& out)
+{
+    return { channel, out };
+}
+
+/// \brief waits until one of the sources is ready or the wait is interrupted according to the until object
+///
+/// The sources are co::recv() cases of co::channel (ts_channel, unbounded_channel) and co::events. One event is
+/// registered in all the sources instead of running a co::thread per source: a producer hands its value over right to
+/// the select and the other producers see that the select is already won, so the value is popped from exactly one
+/// channel. A closed and drained channel is ready too, its out is reset. A notified event stays notified.
+///
+/// If several sources are ready the first one in the argument order is taken. The sources must be either all thread
+/// safe or all not thread safe.
+///
+/// Usage:
+/// \code
+///     std::optional<int> number;
+///     std::optional<std::string> text;
+///     auto res = co_await co::select(co::until(100ms), co::recv(numbers, number), co::recv(texts, text), stop_event);
+///     if (res.is_err())
+///         std::cout << "interrupted\n";
+///     else if (res.unwrap() == 0 && number)
+///         std::cout << "number " << *number << "\n";
+/// \endcode
+///
+/// \return the index of the ready source, co::cancel, co::timeout
+template <typename... Sources>
+co::func<co::result<size_t>> select(co::until until, Sources&&... sources) requires(
+    sizeof...(Sources) > 0 && (impl::select_source<Sources> && ...))
+{
+    return impl::select(std::move(until),
+                        std::tuple<impl::select_case_t<Sources>...>(std::forward<Sources>(sources)...));
+}
+
+/// \brief waits until one of the sources is ready, see select(co::until, sources...)
+template <typename... Sources>
+co::func<co::result<size_t>> select(Sources&&... sources) requires(sizeof...(Sources) > 0 &&
+                                                                    (impl::select_source<Sources> && ...))
+{
+    return impl::select(co::until{}, std::tuple<impl::select_case_t<Sources>...>(std::forward<Sources>(sources)...));
+}
+
+}  // namespace co
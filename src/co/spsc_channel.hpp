@@ -0,0 +1,472 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+
+#include <co/check.hpp>
+#include <co/impl/cache_line.hpp>
+#include <co/impl/waiting_queue.hpp>
+#include <co/status_codes.hpp>
+#include <co/until.hpp>
+
+namespace co::impl
+{
+
+/// \brief lock free ring buffer with one producer and one consumer
+///
+/// head and tail are positions which only grow, the slot of a position is position & mask. Each side caches the last
+/// seen position of the other side, thus it touches the other side's cache line only when the cached value says the
+/// ring is full (empty).
+///
+/// The lowest bit of the tail word is the closed flag, the tail position is kept in the rest of the bits. The producer
+/// publishes an item by a CAS of the tail word, so an item is either published before the ring is closed or never.
+template <typename T>
+class spsc_ring
+{
+    struct slot
+    {
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+public:
+    explicit spsc_ring(size_t capacity)
+        : _capacity(capacity)
+        , _mask(std::bit_ceil(capacity) - 1)
+        , _slots(std::make_unique<slot[]>(_mask + 1))
+    {
+        CO_CHECK(capacity > 0) << "spsc_channel capacity should be greater than 0";
+    }
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    ~spsc_ring()
+    {
+        const size_t tail = _tail.load(std::memory_order::relaxed) >> 1;
+        for (size_t pos = _head.load(std::memory_order::relaxed); pos != tail; pos++)
+            std::destroy_at(item(pos));
+    }
+
+    /// \brief producer side
+    /// \return ok, co::full, co::closed
+    template <typename T2>
+    co::result<void> try_push(T2&& t)
+    {
+        const size_t tail = _tail.load(std::memory_order::relaxed);
+        if (tail & closed_bit)
+            return co::err(co::closed);
+        const size_t pos = tail >> 1;
+        if (pos - _cached_head == _capacity)
+        {
+            _cached_head = _head.load(std::memory_order::acquire);
+            if (pos - _cached_head == _capacity)
+                return co::err(co::full);
+        }
+        std::construct_at(item(pos), std::forward<T2>(t));
+        // only close() changes the tail word besides the producer
+        size_t expected = tail;
+        if (!_tail.compare_exchange_strong(expected, tail + 2, std::memory_order::release, std::memory_order::relaxed))
+        {
+            std::destroy_at(item(pos));
+            return co::err(co::closed);
+        }
+        return co::ok();
+    }
+
+    /// \brief consumer side
+    /// \return ok, co::empty, co::closed when the ring is closed and drained
+    co::result<void> try_pop(std::optional<T>& t)
+    {
+        const size_t head = _head.load(std::memory_order::relaxed);
+        if (head == _cached_tail)
+        {
+            const size_t tail = _tail.load(std::memory_order::acquire);
+            _cached_tail = tail >> 1;
+            if (head == _cached_tail)
+                return (tail & closed_bit) ? co::err(co::closed) : co::err(co::empty);
+        }
+        T* ptr = item(head);
+        t.emplace(std::move(*ptr));
+        std::destroy_at(ptr);
+        _head.store(head + 1, std::memory_order::release);
+        return co::ok();
+    }
+
+    /// \brief closes the ring, can be called from any side
+    void close() noexcept
+    {
+        _tail.fetch_or(closed_bit, std::memory_order::seq_cst);
+    }
+
+    [[nodiscard]] bool is_closed() const noexcept
+    {
+        return (_tail.load(std::memory_order::acquire) & closed_bit) != 0;
+    }
+
+    /// \brief can be called from any side, the result might be stale immediately
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _head.load(std::memory_order::acquire) == (_tail.load(std::memory_order::acquire) >> 1);
+    }
+
+    /// \brief can be called from any side, the result might be stale immediately
+    [[nodiscard]] bool full() const noexcept
+    {
+        return (_tail.load(std::memory_order::acquire) >> 1) - _head.load(std::memory_order::acquire) == _capacity;
+    }
+
+private:
+    static constexpr size_t closed_bit = 1;
+
+    T* item(size_t pos) noexcept
+    {
+        return std::launder(reinterpret_cast<T*>(_slots[pos & _mask].storage));
+    }
+
+    const size_t _capacity;
+    const size_t _mask;
+    std::unique_ptr<slot[]> _slots;
+
+    // consumer's data
+    alignas(cache_line_size) std::atomic<size_t> _head = 0;
+    size_t _cached_tail = 0;
+
+    // producer's data, the tail position and the closed flag
+    alignas(cache_line_size) std::atomic<size_t> _tail = 0;
+    size_t _cached_head = 0;
+};
+
+/// \brief a side of spsc_channel which can be parked until the other side makes progress
+///
+/// The parked flag is raised under the mutex before the side rechecks the ring and waits. The other side checks the
+/// flag after it updates the ring and takes the mutex only if the flag is raised, so the fast path is lock free. Both
+/// sides put a seq_cst fence between the ring update and the flag check, so either the parked side sees the update
+/// or the other side sees the flag.
+struct spsc_parking
+{
+    std::mutex mutex;
+    std::atomic<bool> parked = false;
+    ts_waiting_queue queue;
+
+    /// \brief wakes up the parked side if any. Called by the other side after it has updated the ring
+    void unpark()
+    {
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (!parked.load(std::memory_order::relaxed))
+            return;
+        std::unique_lock lk(mutex);
+        queue.notify_all();
+    }
+};
+
+template <typename T>
+struct spsc_channel_shared_state
+{
+    explicit spsc_channel_shared_state(size_t capacity)
+        : ring(capacity)
+    {}
+
+    spsc_ring<T> ring;
+    alignas(cache_line_size) spsc_parking producer;
+    alignas(cache_line_size) spsc_parking consumer;
+};
+
+}  // namespace co::impl
+
+namespace co
+{
+
+/// \brief buffered channel to pass data of type T from one producer to one consumer
+///
+/// Has the same interface and semantics as co::ts_channel, but only one co::thread or std::thread can push and only
+/// one can pop at the same time (they can be in different OS threads). The items are kept in a lock free ring buffer,
+/// a mutex is taken only to park a side when the channel is full (empty) and to wake the parked side up.
+///
+/// A push either puts the value into the channel or returns co::closed, even when it races with close(). A value
+/// passed as an rvalue might be moved from in the latter case.
+///
+/// spsc_channel owns a count referenced data inside. Thus it's cheap to copy a spsc_channel.
+/// Usage:
+/// \code
+///     co::spsc_channel<int> ch(1024);
+///
+///     std::thread producer([ch]() mutable {
+///         for (int i = 0; i < 100; i++)
+///             ch.blocking_push(i).unwrap();
+///         ch.close();
+///     });
+///
+///     co::loop([ch]() mutable -> co::func<void> {
+///         while (true)
+///         {
+///             auto val = co_await ch.pop();
+///             if (val == co::closed)
+///                 break;
+///         }
+///     });
+///     producer.join();
+/// \endcode
+template <typename T>
+class spsc_channel
+{
+public:
+    /// \brief create a new channel with capacity
+    explicit spsc_channel(size_t capacity)
+        : _state(std::make_shared<impl::spsc_channel_shared_state<T>>(capacity))
+    {}
+
+    /// \brief pushes a new value to the channel. Returns co::full if the channel is full
+    /// \return ok, co::full, co::close
+    template <typename T2>
+    co::result<void> try_push(T2&& t) requires(std::is_constructible_v<T, T2>);
+
+    /// \brief pushes a new value to the channel. Blocks until the channel has space or is interrupted
+    /// \return ok, co::close, co::cancel, co::timeout
+    template <typename T2>
+    co::func<co::result<void>> push(T2&& t, co::until until = {}) requires(std::is_constructible_v<T, T2>);
+
+    /// \brief the blocking version of push(). Blocks the current OS thread until the channel has space or is closed
+    template <typename T2>
+    co::result<void> blocking_push(T2&& t) requires(std::is_constructible_v<T, T2>);
+
+    /// \brief the blocking version of push(). Blocks the current OS thread until the channel has space, is closed or
+    /// timeout has occurred
+    template <typename T2, typename Rep, typename Period>
+    co::result<void> blocking_push(T2&& t,
+                                   std::chrono::duration<Rep, Period> timeout) requires(std::is_constructible_v<T, T2>);
+
+    /// \brief pop the front value from the channel or returns co::empty
+    /// \return ok, co::empty, co::close
+    co::result<T> try_pop();
+
+    /// \brief pop the front value from the channel. Blocks until the channel has some values or is interrupted
+    /// \return ok, co::close, co::cancel, co::timeout
+    co::func<co::result<T>> pop(co::until until = {});
+
+    /// \brief the blocking version of pop(). Blocks the current OS thread until the channel has a value or is closed
+    co::result<T> blocking_pop();
+
+    /// \brief the blocking version of pop(). Blocks the current OS thread until the channel has a value, is closed or
+    /// timeout has occurred
+    template <typename Rep, typename Period>
+    co::result<T> blocking_pop(std::chrono::duration<Rep, Period> timeout);
+
+    /// \brief closes the channel. Pop operations will return co::closed after drained last elements. Can be called
+    /// from any side
+    void close();
+
+    /// \brief returns true if the channel is closed
+    [[nodiscard]] bool is_closed() const;
+
+private:
+    void check_shared_state() const
+    {
+        CO_CHECK(_state != nullptr) << "Propbably you are trying to use the channel after a move.";
+    }
+
+    /// \brief parks the producer until the ring has space or the channel is closed
+    co::func<co::result<void>> wait_space(const co::until& until);
+
+    /// \brief parks the consumer until the ring has an item or the channel is closed
+    co::func<co::result<void>> wait_item(const co::until& until);
+
+    /// \brief parks the current OS thread, `ready` is checked after the parked flag is raised
+    template <typename Ready, typename Rep, typename Period>
+    static co::result<void> blocking_wait(impl::spsc_parking& parking,
+                                          Ready&& ready,
+                                          std::chrono::duration<Rep, Period> timeout);
+
+    std::shared_ptr<impl::spsc_channel_shared_state<T>> _state;
+};
+
+template <typename T>
+template <typename T2>
+co::result<void> spsc_channel<T>::try_push(T2&& t) requires(std::is_constructible_v<T, T2>)
+{
+    check_shared_state();
+    auto res = _state->ring.try_push(std::forward<T2>(t));
+    if (res.is_ok())
+        _state->consumer.unpark();
+    return res;
+}
+
+template <typename T>
+template <typename T2>
+co::func<co::result<void>> spsc_channel<T>::push(T2&& t, co::until until) requires(std::is_constructible_v<T, T2>)
+{
+    check_shared_state();
+    while (true)
+    {
+        auto res = _state->ring.try_push(std::forward<T2>(t));
+        if (res.is_ok())
+            break;
+        if (res == co::closed)
+            co_return res;
+        auto wait_res = co_await wait_space(until);
+        if (wait_res.is_err())
+            co_return wait_res.err();
+    }
+    _state->consumer.unpark();
+    if (impl::consume_budget())
+        co_await impl::yield_awaiter{};
+    co_return co::ok();
+}
+
+template <typename T>
+template <typename T2>
+co::result<void> spsc_channel<T>::blocking_push(T2&& t) requires(std::is_constructible_v<T, T2>)
+{
+    return blocking_push(std::forward<T2>(t), std::chrono::steady_clock::duration::max());
+}
+
+template <typename T>
+template <typename T2, typename Rep, typename Period>
+co::result<void> spsc_channel<T>::blocking_push(T2&& t, std::chrono::duration<Rep, Period> timeout) requires(
+    std::is_constructible_v<T, T2>)
+{
+    check_shared_state();
+    while (true)
+    {
+        auto res = _state->ring.try_push(std::forward<T2>(t));
+        if (res.is_ok())
+            break;
+        if (res == co::closed)
+            return res;
+        auto wait_res = blocking_wait(
+            _state->producer, [this]() { return !_state->ring.full() || _state->ring.is_closed(); }, timeout);
+        if (wait_res.is_err())
+            return wait_res.err();
+    }
+    _state->consumer.unpark();
+    return co::ok();
+}
+
+template <typename T>
+co::result<T> spsc_channel<T>::try_pop()
+{
+    check_shared_state();
+    std::optional<T> item;
+    auto res = _state->ring.try_pop(item);
+    if (res.is_err())
+        return res.err();
+    _state->producer.unpark();
+    return co::ok(std::move(*item));
+}
+
+template <typename T>
+co::func<co::result<T>> spsc_channel<T>::pop(co::until until)
+{
+    check_shared_state();
+    while (true)
+    {
+        auto res = try_pop();
+        if (res.is_ok())
+        {
+            if (impl::consume_budget())
+                co_await impl::yield_awaiter{};
+            co_return res;
+        }
+        if (res == co::closed)
+            co_return res;
+        auto wait_res = co_await wait_item(until);
+        if (wait_res.is_err())
+            co_return wait_res.err();
+    }
+}
+
+template <typename T>
+co::result<T> spsc_channel<T>::blocking_pop()
+{
+    return blocking_pop(std::chrono::steady_clock::duration::max());
+}
+
+template <typename T>
+template <typename Rep, typename Period>
+co::result<T> spsc_channel<T>::blocking_pop(std::chrono::duration<Rep, Period> timeout)
+{
+    check_shared_state();
+    while (true)
+    {
+        auto res = try_pop();
+        if (res.is_ok() || res == co::closed)
+            return res;
+        auto wait_res = blocking_wait(
+            _state->consumer,
+            [this]() { return !_state->ring.empty() || _state->ring.is_closed(); },
+            timeout);
+        if (wait_res.is_err())
+            return wait_res.err();
+    }
+}
+
+template <typename T>
+void spsc_channel<T>::close()
+{
+    check_shared_state();
+    _state->ring.close();
+    _state->producer.unpark();
+    _state->consumer.unpark();
+}
+
+template <typename T>
+bool spsc_channel<T>::is_closed() const
+{
+    check_shared_state();
+    return _state->ring.is_closed();
+}
+
+template <typename T>
+co::func<co::result<void>> spsc_channel<T>::wait_space(const co::until& until)
+{
+    auto& parking = _state->producer;
+    std::unique_lock lk(parking.mutex);
+    parking.parked.store(true, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    co::result<void> res = co::ok();
+    if (_state->ring.full() && !_state->ring.is_closed())
+        res = co_await parking.queue.wait(lk, until);
+    parking.parked.store(false, std::memory_order::relaxed);
+    co_return res;
+}
+
+template <typename T>
+co::func<co::result<void>> spsc_channel<T>::wait_item(const co::until& until)
+{
+    auto& parking = _state->consumer;
+    std::unique_lock lk(parking.mutex);
+    parking.parked.store(true, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    co::result<void> res = co::ok();
+    if (_state->ring.empty() && !_state->ring.is_closed())
+        res = co_await parking.queue.wait(lk, until);
+    parking.parked.store(false, std::memory_order::relaxed);
+    co_return res;
+}
+
+template <typename T>
+template <typename Ready, typename Rep, typename Period>
+co::result<void> spsc_channel<T>::blocking_wait(impl::spsc_parking& parking,
+                                                Ready&& ready,
+                                                std::chrono::duration<Rep, Period> timeout)
+{
+    std::unique_lock lk(parking.mutex);
+    parking.parked.store(true, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    co::result<void> res = co::ok();
+    if (!ready())
+    {
+        if (timeout == std::chrono::duration<Rep, Period>::max())
+            parking.queue.blocking_wait(lk);
+        else
+            res = parking.queue.blocking_wait(lk, timeout);
+    }
+    parking.parked.store(false, std::memory_order::relaxed);
+    return res;
+}
+
+}  // namespace co
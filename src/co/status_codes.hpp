@@ -14,7 +14,8 @@ enum core_codes
     full = 4,
     closed = 5,
     broken = 6,
-    other = 7
+    other = 7,
+    lagged = 8
 };
 
 class core_codes_category : public status_category
@@ -49,6 +50,8 @@ public:
             return "closed";
         case core_codes::other:
             return "other";
+        case core_codes::lagged:
+            return "lagged";
         }
         CO_DCHECK(false);
         return "undefined";
@@ -74,5 +77,6 @@ constexpr auto full = impl::make_status_code(impl::core_codes::full);
 constexpr auto empty = impl::make_status_code(impl::core_codes::empty);
 constexpr auto closed = impl::make_status_code(impl::core_codes::closed);
 constexpr auto other = impl::make_status_code(impl::core_codes::other);
+constexpr auto lagged = impl::make_status_code(impl::core_codes::lagged);
 
 }  // namespace co
\ No newline at end of file
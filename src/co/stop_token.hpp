@@ -9,6 +9,14 @@ namespace co
 
 using stop_callback_func = std::function<void()>;
 
+/// \brief tag to construct co::stop_source without an associated stop state (like std::nostopstate)
+struct nostopstate_t
+{
+    explicit nostopstate_t() = default;
+};
+
+inline constexpr nostopstate_t nostopstate{};
+
 namespace impl
 {
 
@@ -108,6 +116,16 @@ public:
         : _stop_state(std::make_shared<impl::stop_state>())
     {}
 
+    /// \brief creates a stop source without a stop state. Doesn't allocate
+    explicit stop_source(nostopstate_t) noexcept
+    {}
+
+    /// \brief checks whether the stop source has a stop state
+    [[nodiscard]] bool stop_possible() const noexcept
+    {
+        return _stop_state != nullptr;
+    }
+
     [[nodiscard]] stop_token get_token() const
     {
         return stop_token(_stop_state);
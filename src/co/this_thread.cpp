@@ -6,7 +6,7 @@ namespace co
 
 const std::string& this_thread::name() noexcept
 {
-    return co::impl::this_thread_storage_ref().name;
+    return co::impl::this_thread_storage_ref().get_name();
 }
 
 uint64_t this_thread::id() noexcept
@@ -14,14 +14,24 @@ uint64_t this_thread::id() noexcept
     return co::impl::this_thread_storage_ref().id;
 }
 
+co::priority this_thread::priority() noexcept
+{
+    return co::impl::this_thread_storage_ref().priority_class;
+}
+
+void this_thread::set_priority(co::priority priority) noexcept
+{
+    co::impl::this_thread_storage_ref().priority_class = priority;
+}
+
 co::stop_token this_thread::stop_token() noexcept
 {
-    return co::impl::this_thread_storage_ref().stop.get_token();
+    return co::impl::this_thread_storage_ref().get_stop_source().get_token();
 }
 
 bool this_thread::stop_requested() noexcept
 {
-    return co::impl::this_thread_storage_ref().stop.stop_requested();
+    return co::impl::this_thread_storage_ref().stop_requested();
 }
 
 }
\ No newline at end of file
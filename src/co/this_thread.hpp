@@ -4,6 +4,7 @@
 #include <co/check.hpp>
 #include <co/event.hpp>
 #include <co/func.hpp>
+#include <co/priority.hpp>
 #include <co/stop_token.hpp>
 
 namespace co::this_thread
@@ -18,10 +19,31 @@ uint64_t id() noexcept;
 /// \brief get the stop token of the current co::thread. Will terminate if called outside of co::thread
 co::stop_token stop_token() noexcept;
 
+/// \brief get the priority class of the current co::thread. Will terminate if called outside of co::thread
+co::priority priority() noexcept;
+
+/// \brief changes the priority class of the current co::thread. Takes effect the next time the co::thread is woken
+/// up. Will terminate if called outside of co::thread
+void set_priority(co::priority priority) noexcept;
+
 /// \brief returns true if current co::thread has been requested to stop. Will terminate if called outside of
 /// co::thread
 bool stop_requested() noexcept;
 
+/// \brief suspends the current co::thread until the next iteration of the event loop
+///
+/// Other ready co::threads, I/O and timers are processed before the co::thread is resumed. Will terminate if called
+/// outside of co::thread
+///
+/// Usage:
+/// \code
+///     co_await co::this_thread::yield();
+/// \endcode
+inline impl::yield_awaiter yield()
+{
+    return impl::yield_awaiter{};
+}
+
 /// \brief waits for sleep_duration amount of time
 template <class Rep, class Period>
 co::func<void> sleep_for(std::chrono::duration<Rep, Period> sleep_duration)
@@ -1,23 +1,24 @@
 #pragma once
 
+#include <atomic>
 #include <string>
+#include <co/check.hpp>
+#include <co/event.hpp>
 #include <co/func.hpp>
+#include <co/priority.hpp>
 #include <co/std.hpp>
 #include <co/until.hpp>
-#include <co/impl/timer.hpp>
+#include <co/impl/scheduler.hpp>
+#include <co/impl/thread_storage.hpp>
 
 namespace co
 {
 
-template <bool ThreadSafe>
-class event_base;
-
-using event = event_base<false>;
+class loop_group;
 
 namespace impl
 {
 
-struct thread_storage;
 class thread_func;
 
 class thread_func_promise : public func_promise_base<void>
@@ -51,13 +52,37 @@ public:
 };
 
 
+/// \brief the state shared between co::thread object and its execution context. Allocated once per co::thread
+struct thread_state
+{
+    thread_storage storage;
+    // thread safe because the co::thread might be run by another worker (see co::loop(n_workers, f))
+    ts_event finish;
+};
+
 /// \brief wrap func into a separate co::thread execution context
-/// \param func the work need to be concurrently run
-/// \param finish signal that the current thread is finished
-/// \param thread_storage current co::thread local storage
-inline thread_func create_thread_main_func(func<void> func,
-                                           std::shared_ptr<event> finish,
-                                           std::shared_ptr<thread_storage> thread_storage);
+/// \param f co::func<void> or a lambda returning co::func<void>. The lambda lives in the coroutine frame, thus there is
+/// no need to wrap it with co::invoke
+/// \param state the state of the co::thread. finish is notified when the co::thread is finished
+template <typename F>
+thread_func create_thread_main_func(F f, std::shared_ptr<thread_state> state)
+{
+    try
+    {
+        set_this_thread_storage_ptr(&state->storage);
+        if constexpr (is_func_v<F>)
+            co_await f;
+        else
+            co_await f();
+    }
+    catch (const std::exception& exc)
+    {
+        CO_CHECK(true) << "unhandled exception: " << exc.what();
+    }
+    state->finish.notify();
+    set_this_thread_storage_ptr(nullptr);
+    get_scheduler().thread_finished();
+}
 
 }  // namespace impl
 
@@ -79,15 +104,26 @@ inline thread_func create_thread_main_func(func<void> func,
 ///         co_await co::this_thread::sleep_for(100ms);
 ///     }).detached();
 /// \endcode
+///
+/// The priority class of the thread defines how often the thread is resumed when there are other ready threads:
+/// \code
+///     co::thread(compaction(), "compaction", co::priority::low).detach();
+/// \endcode
 class thread
 {
+    friend class loop_group;
+
 public:
     template <FuncLambdaConcept F>
-    explicit thread(F&& f, const std::string& thread_name = "")
-        : thread(co::invoke(std::forward<F>(f)), thread_name)
+    explicit thread(F&& f, const std::string& thread_name = "", co::priority priority = co::priority::normal)
+        : thread(impl::get_scheduler(), std::forward<F>(f), thread_name, priority)
     {}
 
-    explicit thread(func<void>&& func, const std::string& thread_name = "");
+    explicit thread(func<void>&& func,
+                    const std::string& thread_name = "",
+                    co::priority priority = co::priority::normal)
+        : thread(impl::get_scheduler(), std::move(func), thread_name, priority)
+    {}
 
     ~thread();
 
@@ -136,12 +172,22 @@ public:
     void request_stop() const;
 
 private:
-    static inline uint64_t id = 0;
+    /// \brief schedules the thread to be run by the given scheduler
+    template <typename F>
+    thread(impl::scheduler& scheduler, F&& f, const std::string& thread_name, co::priority priority)
+        : _state(std::make_shared<impl::thread_state>())
+    {
+        impl::init_thread_storage(_state->storage, thread_name, ++id, priority, &scheduler);
+        impl::thread_func thread_func = impl::create_thread_main_func<std::decay_t<F>>(std::forward<F>(f), _state);
+        _state->storage.suspended_coroutine = thread_func._coroutine;
+        scheduler.spawn(&_state->storage);
+    }
+
+private:
+    static inline std::atomic<uint64_t> id = 0;
 
     bool _detached = false;
-    std::shared_ptr<impl::thread_storage> _thread_storage_ptr;
-    std::shared_ptr<event> _event_ptr;
-    impl::thread_func _thread_func;
+    std::shared_ptr<impl::thread_state> _state;
 };
 
 
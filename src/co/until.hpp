@@ -3,6 +3,7 @@
 #include <chrono>
 #include <optional>
 #include <variant>
+#include <co/loop_clock.hpp>
 #include <co/stop_token.hpp>
 
 namespace co
@@ -12,6 +13,9 @@ namespace impl
 {
 
 /// \brief converts time point from Clock to TargetClock
+///
+/// NOTE: time points of clocks sharing the epoch (like co::loop_clock and std::chrono::steady_clock) are converted
+/// without reading the clocks
 template <typename TargetClock, typename Clock, typename Duration>
 typename TargetClock::time_point time_point_conv(const std::chrono::time_point<Clock, Duration>& time)
 {
@@ -25,7 +29,7 @@ typename TargetClock::time_point time_point_conv(const std::chrono::time_point<C
     if (time == time_point_type::max())
         return target_time_point::max();
 
-    if constexpr (std::is_same_v<Clock, TargetClock>)
+    if constexpr (std::is_same_v<Clock, typename target_time_point::clock>)
     {
         return std::chrono::time_point_cast<target_duration_type>(time);
     }
@@ -65,8 +69,9 @@ typename TargetClock::time_point time_point_conv(const std::chrono::time_point<C
 ///
 class until
 {
-    using clock_type = std::chrono::steady_clock;
-    using time_type = std::chrono::steady_clock::time_point;
+    // the cached time of the event loop is used to compute the time left to the deadline
+    using clock_type = co::loop_clock;
+    using time_type = clock_type::time_point;
     using duration_type = clock_type::duration;
     using deadline_variants = std::variant<std::monostate, time_type, duration_type>;
 
@@ -151,6 +156,23 @@ public:
         return _token;
     }
 
+    /// \brief returns the time left until cancellation, if timeout or deadline are set.
+    ///
+    /// returns std::nullopt otherwise
+    [[nodiscard]] std::optional<std::chrono::nanoseconds> nanoseconds() const
+    {
+        if (std::holds_alternative<time_type>(_deadline))
+        {
+            const auto time_point = std::get<time_type>(_deadline);
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(time_point - clock_type::now());
+        }
+        else if (std::holds_alternative<duration_type>(_deadline))
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::get<duration_type>(_deadline));
+        }
+        return std::nullopt;
+    }
+
     /// \brief returns number of milliseconds until cancellation, if timeout or deadline are set.
     ///
     /// returns std::nullopt otherwise
@@ -159,7 +181,7 @@ public:
         if (std::holds_alternative<time_type>(_deadline))
         {
             const auto time_point = std::get<time_type>(_deadline);
-            return std::chrono::round<std::chrono::milliseconds>(time_point - clock_type ::now()).count();
+            return std::chrono::round<std::chrono::milliseconds>(time_point - clock_type::now()).count();
         }
         else if (std::holds_alternative<duration_type>(_deadline))
         {
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <co/channel.hpp>
+#include <co/check.hpp>
+#include <co/impl/waiting_queue.hpp>
+#include <co/status_codes.hpp>
+#include <co/until.hpp>
+
+namespace co::impl
+{
+
+template <typename T, bool ThreadSafe>
+struct watch_shared_state
+{
+    using lock_type = std::conditional_t<ThreadSafe, std::mutex, dummy_mutex>;
+
+    template <typename T2>
+    explicit watch_shared_state(T2&& initial)
+        : _value(std::forward<T2>(initial))
+    {}
+
+    // the version is read without the lock, so readers which have seen the last version don't touch the mutex
+    std::atomic<uint64_t> _version = 0;
+    lock_type _mutex;
+    bool _closed = false;
+    T _value;
+    waiting_queue_base<ThreadSafe> _readers_waiting_queue;
+};
+
+}  // namespace co::impl
+
+namespace co
+{
+
+template <typename T, bool ThreadSafe>
+class watch_receiver;
+
+/// \brief keeps the latest value of some state and notifies the readers about its changes
+/// \tparam T type of the state, it should be copyable
+///
+/// There is no queue: a new version replaces the previous one, thus a slow reader skips the intermediate versions and
+/// gets the newest one. Every watch_receiver remembers the last version it has seen.
+///
+/// watch owns a count referenced data inside. Thus it's cheap to copy it.
+/// Usage:
+/// \code
+///     co::watch<config> cfg(load_config());
+///     auto th = co::thread(
+///         [rx = cfg.subscribe()]() mutable -> co::func<void>
+///         {
+///             while (true)
+///             {
+///                 auto res = co_await rx.changed();
+///                 if (res == co::closed)
+///                     break;
+///                 apply(res.unwrap());
+///             }
+///         });
+///     cfg.publish(load_config());
+///     cfg.close();
+/// \endcode
+template <typename T, bool ThreadSafe>
+class watch_base
+{
+public:
+    /// \brief create a new watch holding the initial value as the version 0
+    template <typename T2>
+    explicit watch_base(T2&& initial) requires(std::is_constructible_v<T, T2>)
+        : _state(std::make_shared<impl::watch_shared_state<T, ThreadSafe>>(std::forward<T2>(initial)))
+    {}
+
+    /// \brief replaces the value with a new version and wakes up all the waiting readers
+    /// \return ok, co::closed
+    template <typename T2>
+    co::result<void> publish(T2&& t) requires(std::is_assignable_v<T&, T2>);
+
+    /// \brief returns a copy of the latest value
+    T get() const;
+
+    /// \brief returns the latest version, it grows with every publish()
+    [[nodiscard]] uint64_t version() const noexcept
+    {
+        check_shared_state();
+        return _state->_version.load(std::memory_order::acquire);
+    }
+
+    /// \brief creates a receiver which has seen the current version
+    watch_receiver<T, ThreadSafe> subscribe() const;
+
+    /// \brief closes the watch. Readers will get co::closed after they have seen the last version
+    void close();
+
+    /// \brief returns true if the watch is closed
+    [[nodiscard]] bool is_closed() const;
+
+private:
+    void check_shared_state() const
+    {
+        CO_CHECK(_state != nullptr) << "Propbably you are trying to use the watch after a move.";
+    }
+
+private:
+    std::shared_ptr<impl::watch_shared_state<T, ThreadSafe>> _state;
+};
+
+/// \brief reader of a watch. A receiver is meant to be used by one co::thread
+template <typename T, bool ThreadSafe>
+class watch_receiver
+{
+    friend class watch_base<T, ThreadSafe>;
+
+public:
+    /// \brief returns true if there is a version the receiver hasn't seen yet. Doesn't lock
+    [[nodiscard]] bool has_changed() const noexcept
+    {
+        return _state->_version.load(std::memory_order::acquire) != _seen;
+    }
+
+    /// \brief returns a copy of the latest value and marks it as seen
+    T get();
+
+    /// \brief waits for a version the receiver hasn't seen yet and returns a copy of the latest value
+    /// \return ok, co::closed, co::cancel, co::timeout
+    co::func<co::result<T>> changed(co::until until = {});
+
+    /// \brief The blocking version of changed(). It will block the current OS thread until a new version is published
+    /// or the watch is closed
+    /// \return ok, co::closed
+    co::result<T> blocking_changed() requires(ThreadSafe);
+
+    /// \brief The blocking version of changed(). It will block the current OS thread until a new version is published,
+    /// the watch is closed or timeout has occured
+    /// \return ok, co::closed, co::timeout
+    template <typename Rep, typename Period>
+    co::result<T> blocking_changed(std::chrono::duration<Rep, Period> timeout) requires(ThreadSafe);
+
+private:
+    watch_receiver(std::shared_ptr<impl::watch_shared_state<T, ThreadSafe>> state, uint64_t seen)
+        : _state(std::move(state))
+        , _seen(seen)
+    {}
+
+    void check_shared_state() const
+    {
+        CO_CHECK(_state != nullptr) << "Propbably you are trying to use the receiver after a move.";
+    }
+
+    /// \brief copies the latest value if it hasn't been seen. Must be called under the mutex
+    co::result<T> get_changed_locked();
+
+private:
+    std::shared_ptr<impl::watch_shared_state<T, ThreadSafe>> _state;
+    uint64_t _seen;
+};
+
+template <typename T, bool ThreadSafe>
+template <typename T2>
+co::result<void> watch_base<T, ThreadSafe>::publish(T2&& t) requires(std::is_assignable_v<T&, T2>)
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    if (_state->_closed)
+        return co::err(co::closed);
+
+    _state->_value = std::forward<T2>(t);
+    _state->_version.fetch_add(1, std::memory_order::release);
+    _state->_readers_waiting_queue.notify_all();
+    return co::ok();
+}
+
+template <typename T, bool ThreadSafe>
+T watch_base<T, ThreadSafe>::get() const
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    return _state->_value;
+}
+
+template <typename T, bool ThreadSafe>
+watch_receiver<T, ThreadSafe> watch_base<T, ThreadSafe>::subscribe() const
+{
+    check_shared_state();
+    return { _state, _state->_version.load(std::memory_order::acquire) };
+}
+
+template <typename T, bool ThreadSafe>
+void watch_base<T, ThreadSafe>::close()
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    _state->_closed = true;
+    _state->_readers_waiting_queue.notify_all();
+}
+
+template <typename T, bool ThreadSafe>
+[[nodiscard]] bool watch_base<T, ThreadSafe>::is_closed() const
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    return _state->_closed;
+}
+
+template <typename T, bool ThreadSafe>
+co::result<T> watch_receiver<T, ThreadSafe>::get_changed_locked()
+{
+    // the version is changed under the mutex, a relaxed load is enough here
+    const uint64_t version = _state->_version.load(std::memory_order::relaxed);
+    if (version != _seen)
+    {
+        _seen = version;
+        return co::ok(T(_state->_value));
+    }
+    return _state->_closed ? co::err(co::closed) : co::err(co::empty);
+}
+
+template <typename T, bool ThreadSafe>
+T watch_receiver<T, ThreadSafe>::get()
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    _seen = _state->_version.load(std::memory_order::relaxed);
+    return _state->_value;
+}
+
+template <typename T, bool ThreadSafe>
+co::func<co::result<T>> watch_receiver<T, ThreadSafe>::changed(co::until until)
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    while (true)
+    {
+        co::result<T> res = get_changed_locked();
+        if (res != co::empty)
+        {
+            lk.unlock();
+            if (impl::consume_budget())
+                co_await impl::yield_awaiter{};
+            co_return res;
+        }
+
+        auto wait_res = co_await _state->_readers_waiting_queue.wait(lk, until);
+        if (wait_res.is_err())
+            co_return wait_res.err();
+    }
+}
+
+template <typename T, bool ThreadSafe>
+co::result<T> watch_receiver<T, ThreadSafe>::blocking_changed() requires(ThreadSafe)
+{
+    return blocking_changed(std::chrono::steady_clock::duration::max());
+}
+
+template <typename T, bool ThreadSafe>
+template <typename Rep, typename Period>
+co::result<T> watch_receiver<T, ThreadSafe>::blocking_changed(std::chrono::duration<Rep, Period> timeout) requires(
+    ThreadSafe)
+{
+    check_shared_state();
+    std::unique_lock lk(_state->_mutex);
+    co::result<void> wait_res = co::ok();
+    // one deadline for the whole call, a wakeup without a new version waits for the rest of the timeout
+    const auto deadline = timeout == std::chrono::duration<Rep, Period>::max()
+                              ? std::chrono::steady_clock::time_point::max()
+                              : std::chrono::steady_clock::now() +
+                                    std::chrono::ceil<std::chrono::steady_clock::duration>(timeout);
+    while (true)
+    {
+        // a version published right at the timeout is still taken
+        co::result<T> res = get_changed_locked();
+        if (res != co::empty)
+            return res;
+        if (wait_res.is_err())
+            return wait_res.err();
+
+        if (timeout == std::chrono::duration<Rep, Period>::max())
+            _state->_readers_waiting_queue.blocking_wait(lk);
+        else
+            wait_res = _state->_readers_waiting_queue.blocking_wait(lk, deadline - std::chrono::steady_clock::now());
+    }
+}
+
+template <typename T>
+using watch = watch_base<T, /*ThreadSafe=*/false>;
+template <typename T>
+using ts_watch = watch_base<T, /*ThreadSafe=*/true>;
+
+}  // namespace co
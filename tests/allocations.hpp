@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+namespace tests
+{
+
+/// \brief get the number of calls of the global operator new made by all OS threads of the process
+uint64_t heap_allocations() noexcept;
+
+}  // namespace tests
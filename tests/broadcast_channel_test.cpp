@@ -0,0 +1,156 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <co/co.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("broadcast_channel delivers every message to every subscriber", "[primitives]")
+{
+    static constexpr int n_subscribers = 10;
+    static constexpr int n_messages = 100;
+    std::vector<std::vector<int>> received(n_subscribers);
+    co::loop(
+        [&received]() -> co::func<void>
+        {
+            co::broadcast_channel<int> ch(4);
+            std::vector<co::thread> threads;
+            for (int i = 0; i < n_subscribers; i++)
+            {
+                threads.emplace_back(
+                    [sub = ch.subscribe(), &values = received[i]]() mutable -> co::func<void>
+                    {
+                        while (true)
+                        {
+                            auto res = co_await sub.pop();
+                            if (res == co::closed)
+                                break;
+                            values.push_back(res.unwrap());
+                        }
+                    });
+            }
+
+            for (int i = 0; i < n_messages; i++)
+            {
+                REQUIRE(ch.push(i).is_ok());
+                // let the subscribers keep up with the producer
+                co_await co::this_thread::yield();
+            }
+            ch.close();
+            REQUIRE(ch.push(n_messages) == co::closed);
+            for (auto& th : threads)
+                co_await th.join();
+        });
+
+    for (const auto& values : received)
+    {
+        REQUIRE(values.size() == n_messages);
+        for (int i = 0; i < n_messages; i++)
+            REQUIRE(values[i] == i);
+    }
+}
+
+TEST_CASE("broadcast_channel lagging subscriber", "[primitives]")
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::broadcast_channel<std::string> ch(3);
+            auto early = ch.subscribe();
+            REQUIRE(early.try_pop() == co::empty);
+            auto res = co_await early.pop({ 5ms });
+            REQUIRE(res == co::timeout);
+
+            for (int i = 0; i < 5; i++)
+                REQUIRE(ch.push(std::to_string(i)).is_ok());
+
+            // a new subscriber receives only the messages pushed after the subscription
+            auto late = ch.subscribe();
+            REQUIRE(late.try_pop() == co::empty);
+
+            // the producer has never waited, the early subscriber has missed the overwritten messages
+            auto copy = early;
+            REQUIRE(early.try_pop() == co::lagged);
+            REQUIRE(early.lagged_by() == 2);
+            REQUIRE(early.try_pop().unwrap() == "2");
+            REQUIRE(early.try_pop().unwrap() == "3");
+            REQUIRE(early.try_pop().unwrap() == "4");
+            REQUIRE(early.try_pop() == co::empty);
+
+            // the copy has its own cursor
+            res = co_await copy.pop();
+            REQUIRE(res == co::lagged);
+            REQUIRE(copy.lagged_by() == 2);
+            res = co_await copy.pop();
+            REQUIRE(res.unwrap() == "2");
+
+            ch.close();
+            REQUIRE(early.try_pop() == co::closed);
+            REQUIRE(copy.try_pop().unwrap() == "3");
+            REQUIRE(late.try_pop() == co::closed);
+        });
+}
+
+TEST_CASE("ts_broadcast_channel from a std::thread to co::threads and std::threads", "[primitives]")
+{
+    static constexpr int n_messages = 1000;
+    co::ts_broadcast_channel<int> ch(n_messages);
+    auto co_sub = ch.subscribe();
+    auto std_sub = ch.subscribe();
+
+    int64_t std_sum = 0;
+    std::thread std_consumer(
+        [&std_sub, &std_sum]()
+        {
+            while (true)
+            {
+                auto res = std_sub.blocking_pop();
+                if (res == co::closed)
+                    break;
+                std_sum += res.unwrap();
+            }
+        });
+    std::thread producer(
+        [ch]() mutable
+        {
+            for (int i = 0; i < n_messages; i++)
+                ch.push(i).unwrap();
+            ch.close();
+        });
+
+    int64_t co_sum = 0;
+    co::loop(
+        [&co_sub, &co_sum]() -> co::func<void>
+        {
+            while (true)
+            {
+                auto res = co_await co_sub.pop();
+                if (res == co::closed)
+                    break;
+                co_sum += res.unwrap();
+            }
+        });
+    producer.join();
+    std_consumer.join();
+    REQUIRE(co_sum == n_messages * (n_messages - 1) / 2);
+    REQUIRE(std_sum == n_messages * (n_messages - 1) / 2);
+}
+
+TEST_CASE("ts_broadcast_channel blocking_pop with a timeout", "[primitives]")
+{
+    co::ts_broadcast_channel<int> ch(4);
+    auto sub = ch.subscribe();
+    REQUIRE(sub.blocking_pop(1ms) == co::timeout);
+
+    std::thread producer(
+        [ch]() mutable
+        {
+            std::this_thread::sleep_for(5ms);
+            ch.push(42).unwrap();
+            ch.close();
+        });
+    REQUIRE(sub.blocking_pop(10s).unwrap() == 42);
+    REQUIRE(sub.blocking_pop(10s) == co::closed);
+    producer.join();
+}
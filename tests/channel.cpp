@@ -2,8 +2,13 @@
 #include <co/channel.hpp>
 #include <co/co.hpp>
 
+#include <array>
+#include <memory>
+#include <numeric>
 #include <thread>
 
+#include "allocations.hpp"
+
 using namespace std::chrono_literals;
 
 TEMPLATE_TEST_CASE("channel usage", "[primitives]", co::channel<int>, co::ts_channel<int>)
@@ -186,4 +191,474 @@ TEST_CASE("ts::channel basic stress test", "[ts][primitives][stress]")
         thread.join();
     }
     REQUIRE(reciever_counter.load(std::memory_order::acquire) == n_elements);
-}
\ No newline at end of file
+}
+
+TEMPLATE_TEST_CASE("channel ping-pong doesn't touch the heap", "[primitives]", co::channel<int>, co::ts_channel<int>)
+{
+    constexpr int n_iterations = 1000;
+    co::loop(
+        []() -> co::func<void>
+        {
+            TestType ping(1);
+            TestType pong(1);
+            auto th = co::thread(
+                [ping, pong]() mutable -> co::func<void>
+                {
+                    while (true)
+                    {
+                        auto val = co_await ping.pop();
+                        if (val == co::closed)
+                            break;
+                        co_await pong.push(val.unwrap() + 1).unwrap();
+                    }
+                });
+
+            // warm up the frame allocator
+            co_await ping.push(0).unwrap();
+            auto first = co_await pong.pop();
+            REQUIRE(first.unwrap() == 1);
+
+            const auto before = co::get_frame_allocator_stats();
+            const auto heap_before = tests::heap_allocations();
+            int n_mismatches = 0;
+            for (int i = 0; i < n_iterations; i++)
+            {
+                co_await ping.push(i).unwrap();
+                auto val = co_await pong.pop();
+                // REQUIRE isn't used in the loop, it may allocate
+                if (val.unwrap() != i + 1)
+                    n_mismatches++;
+            }
+            const auto heap_after = tests::heap_allocations();
+            const auto after = co::get_frame_allocator_stats();
+            REQUIRE(n_mismatches == 0);
+            // the frames of push() and pop() are taken from the free lists, nothing else is allocated
+            REQUIRE(after.allocations - before.allocations == after.reused - before.reused);
+            REQUIRE(heap_after == heap_before);
+            ping.close();
+            co_await th.join();
+        });
+}
+
+TEMPLATE_TEST_CASE("channel push_many and pop_many",
+                   "[primitives]",
+                   co::channel<int>,
+                   co::ts_channel<int>,
+                   co::unbounded_channel<int>,
+                   co::ts_unbounded_channel<int>)
+{
+    static constexpr int n_items = 1000;
+    std::vector<int> received;
+    co::loop(
+        [&received]() -> co::func<void>
+        {
+            TestType ch(16);
+            auto producer = co::thread(
+                [ch]() mutable -> co::func<void>
+                {
+                    std::vector<int> values(n_items);
+                    std::iota(values.begin(), values.end(), 0);
+                    const auto res = co_await ch.push_many(values);
+                    REQUIRE(res.unwrap() == n_items);
+                    ch.close();
+                });
+
+            while (true)
+            {
+                const auto res = co_await ch.pop_many(std::back_inserter(received), 10);
+                if (res == co::closed)
+                    break;
+                REQUIRE(res.unwrap() > 0);
+                REQUIRE(res.unwrap() <= 10);
+            }
+            co_await producer.join();
+        });
+    REQUIRE(received.size() == n_items);
+    for (int i = 0; i < n_items; i++)
+        REQUIRE(received[i] == i);
+}
+
+TEMPLATE_TEST_CASE("channel batch operations are interrupted",
+                   "[primitives]",
+                   co::channel<int>,
+                   co::ts_channel<int>,
+                   co::unbounded_channel<int>,
+                   co::ts_unbounded_channel<int>)
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            TestType ch(2);
+            std::array<int, 3> out{};
+            REQUIRE(ch.try_pop_many(out) == co::empty);
+            auto pop_res = co_await ch.pop_many(out.begin(), out.size(), { 5ms });
+            REQUIRE(pop_res == co::timeout);
+
+            // only the values which fit are pushed before the timeout
+            const std::vector<int> values{ 1, 2, 3 };
+            auto push_res = co_await ch.push_many(values, { 5ms });
+            REQUIRE(push_res.unwrap() == 2);
+            push_res = co_await ch.push_many(values, { 5ms });
+            REQUIRE(push_res == co::timeout);
+
+            REQUIRE(ch.try_pop_many(out).unwrap() == 2);
+            REQUIRE(out[0] == 1);
+            REQUIRE(out[1] == 2);
+
+            const std::vector<int> last_values{ 3, 4 };
+            push_res = co_await ch.push_many(last_values);
+            REQUIRE(push_res.unwrap() == 2);
+            ch.close();
+            push_res = co_await ch.push_many(values);
+            REQUIRE(push_res == co::closed);
+            pop_res = co_await ch.pop_many(out.begin(), out.size());
+            REQUIRE(pop_res.unwrap() == 2);
+            REQUIRE(ch.try_pop_many(out) == co::closed);
+        });
+}
+
+TEMPLATE_TEST_CASE("channel batch wakeup is passed on to other waiters",
+                   "[primitives]",
+                   co::channel<int>,
+                   co::ts_channel<int>)
+{
+    static constexpr int n_items = 1000;
+    int sum = 0;
+    co::loop(
+        [&sum]() -> co::func<void>
+        {
+            TestType items(8);
+            TestType results(8);
+            std::vector<co::thread> threads;
+            // single value consumers of push_many and single value producers of pop_many
+            for (int i = 0; i < 4; i++)
+            {
+                threads.emplace_back(
+                    [items, results]() mutable -> co::func<void>
+                    {
+                        while (true)
+                        {
+                            auto val = co_await items.pop();
+                            if (val == co::closed)
+                                break;
+                            auto res = co_await results.push(val.unwrap());
+                            res.unwrap();
+                        }
+                    });
+            }
+            auto collector = co::thread(
+                [results, &sum]() mutable -> co::func<void>
+                {
+                    std::vector<int> batch;
+                    while (true)
+                    {
+                        batch.clear();
+                        auto res = co_await results.pop_many(std::back_inserter(batch), 8);
+                        if (res == co::closed)
+                            break;
+                        for (int val : batch)
+                            sum += val;
+                    }
+                });
+
+            co_await co::this_thread::sleep_for(1ms);
+            std::vector<int> values(n_items);
+            std::iota(values.begin(), values.end(), 1);
+            const auto res = co_await items.push_many(values);
+            REQUIRE(res.unwrap() == n_items);
+            items.close();
+            for (auto& th : threads)
+                co_await th.join();
+            results.close();
+            co_await collector.join();
+        });
+    REQUIRE(sum == n_items * (n_items + 1) / 2);
+}
+
+TEMPLATE_TEST_CASE("channel hands a value over to a parked consumer",
+                   "[primitives]",
+                   co::channel<int>,
+                   co::ts_channel<int>,
+                   co::unbounded_channel<int>,
+                   co::ts_unbounded_channel<int>)
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            TestType ch(1);
+            auto consumer = co::thread(
+                [ch]() mutable -> co::func<void>
+                {
+                    auto val = co_await ch.pop();
+                    REQUIRE(val.unwrap() == 1);
+                });
+            co_await co::this_thread::sleep_for(1ms);
+            // the first value goes to the parked consumer, the buffer is still empty
+            REQUIRE(ch.try_push(1).is_ok());
+            REQUIRE(ch.try_push(2).is_ok());
+            REQUIRE(ch.try_push(3) == co::full);
+            co_await consumer.join();
+            REQUIRE(ch.try_pop().unwrap() == 2);
+        });
+}
+
+TEMPLATE_TEST_CASE("rendezvous channel",
+                   "[primitives]",
+                   co::channel<int>,
+                   co::ts_channel<int>,
+                   co::unbounded_channel<int>,
+                   co::ts_unbounded_channel<int>)
+{
+    static constexpr int n_items = 100;
+    std::vector<int> received;
+    co::loop(
+        [&received]() -> co::func<void>
+        {
+            TestType ch(0);
+            REQUIRE(ch.try_push(1) == co::full);
+            REQUIRE(ch.try_pop() == co::empty);
+            const auto push_res = co_await ch.push(1, { 5ms });
+            REQUIRE(push_res == co::timeout);
+            auto pop_res = co_await ch.pop({ 5ms });
+            REQUIRE(pop_res == co::timeout);
+
+            auto consumer = co::thread(
+                [ch, &received]() mutable -> co::func<void>
+                {
+                    while (true)
+                    {
+                        auto val = co_await ch.pop();
+                        if (val == co::closed)
+                            break;
+                        received.push_back(val.unwrap());
+                        co_await co::this_thread::yield();
+                    }
+                });
+            for (int i = 0; i < n_items; i++)
+            {
+                auto res = co_await ch.push(i);
+                res.unwrap();
+            }
+            ch.close();
+            co_await consumer.join();
+        });
+    REQUIRE(received.size() == n_items);
+    for (int i = 0; i < n_items; i++)
+        REQUIRE(received[i] == i);
+}
+
+TEST_CASE("ts rendezvous channel between std::threads and co::threads", "[ts][primitives]")
+{
+    static constexpr int n_items = 10000;
+    co::ts_channel<int> requests(0);
+    co::ts_channel<int> responses(0);
+    std::thread client(
+        [requests, responses]() mutable
+        {
+            for (int i = 0; i < n_items; i++)
+            {
+                requests.blocking_push(i).unwrap();
+                CO_CHECK(responses.blocking_pop().unwrap() == i + 1);
+            }
+            requests.close();
+        });
+
+    co::loop(
+        [requests, responses]() mutable -> co::func<void>
+        {
+            while (true)
+            {
+                auto val = co_await requests.pop();
+                if (val == co::closed)
+                    break;
+                auto res = co_await responses.push(val.unwrap() + 1);
+                res.unwrap();
+            }
+        });
+    client.join();
+}
+
+TEMPLATE_TEST_CASE("unbounded channel memory follows the occupancy",
+                   "[primitives]",
+                   co::unbounded_channel<std::shared_ptr<int>>,
+                   co::ts_unbounded_channel<std::shared_ptr<int>>)
+{
+    static constexpr int n_items = 10000;
+    auto item = std::make_shared<int>(1);
+    co::loop(
+        [item]() -> co::func<void>
+        {
+            TestType ch;
+            for (int i = 0; i < n_items; i++)
+                REQUIRE(ch.try_push(item).is_ok());
+            REQUIRE(item.use_count() == n_items + 2);
+            for (int i = 0; i < n_items; i++)
+                REQUIRE(ch.try_pop().is_ok());
+            REQUIRE(ch.try_pop() == co::empty);
+            REQUIRE(item.use_count() == 2);
+
+            // the drained channel keeps spare segments, the next values reuse them
+            const auto heap_before = tests::heap_allocations();
+            bool all_ok = true;
+            for (int i = 0; i < n_items; i++)
+            {
+                all_ok = ch.try_push(item).is_ok() && all_ok;
+                all_ok = ch.try_pop().is_ok() && all_ok;
+            }
+            const auto heap_after = tests::heap_allocations();
+            REQUIRE(all_ok);
+            REQUIRE(heap_after == heap_before);
+            REQUIRE(ch.try_push(item).is_ok());
+            co_return;
+        });
+    // the values left in the channel are destroyed with it
+    REQUIRE(item.use_count() == 1);
+}
+
+TEST_CASE("ts unbounded channel recycles segments between a std::thread producer and a co::thread consumer",
+          "[ts][primitives]")
+{
+    static constexpr int n_warm_up = 10000;
+    static constexpr int n_items = 100000;
+    // the limit keeps at most two segments in use
+    co::ts_unbounded_channel<int> ch(100);
+    std::atomic<uint64_t> n_allocations = 0;
+    std::thread producer(
+        [ch, &n_allocations]() mutable
+        {
+            for (int i = 0; i < n_warm_up; i++)
+                ch.blocking_push(i).unwrap();
+            const auto before = tests::heap_allocations();
+            for (int i = 0; i < n_items; i++)
+                ch.blocking_push(i).unwrap();
+            n_allocations = tests::heap_allocations() - before;
+            ch.close();
+        });
+
+    int64_t sum = 0;
+    co::loop(
+        [ch, &sum]() mutable -> co::func<void>
+        {
+            while (true)
+            {
+                auto res = co_await ch.pop();
+                if (res == co::closed)
+                    break;
+                sum += res.unwrap();
+            }
+        });
+    producer.join();
+    REQUIRE(sum == int64_t{ n_warm_up } * (n_warm_up - 1) / 2 + int64_t{ n_items } * (n_items - 1) / 2);
+    // the segments drained by the consumer go back to the channel, not to the consumer's OS thread
+    REQUIRE(n_allocations == 0);
+}
+
+TEST_CASE("ts unbounded channel with a soft limit between std::threads and co::threads", "[ts][primitives]")
+{
+    static constexpr int n_items = 100000;
+    co::ts_unbounded_channel<int> ch(1000);
+    std::thread producer(
+        [ch]() mutable
+        {
+            for (int i = 0; i < n_items; i++)
+                ch.blocking_push(i).unwrap();
+            ch.close();
+        });
+
+    int expected = 0;
+    co::loop(
+        [ch, &expected]() mutable -> co::func<void>
+        {
+            std::vector<int> batch;
+            while (true)
+            {
+                batch.clear();
+                auto res = co_await ch.pop_many(std::back_inserter(batch), 64);
+                if (res == co::closed)
+                    break;
+                for (int val : batch)
+                    CO_CHECK(val == expected++);
+            }
+        });
+    producer.join();
+    REQUIRE(expected == n_items);
+}
+
+TEST_CASE("lossy channel drops the oldest or the newest values", "[primitives]")
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::lossy_channel<int, co::overflow_policy::drop_oldest> oldest(3);
+            co::lossy_channel<int, co::overflow_policy::drop_newest> newest(3);
+            for (int i = 0; i < 5; i++)
+            {
+                REQUIRE(oldest.try_push(i).is_ok());
+                auto res = co_await newest.push(i);
+                REQUIRE(res.is_ok());
+            }
+            REQUIRE(oldest.dropped() == 2);
+            REQUIRE(newest.dropped() == 2);
+
+            for (int i = 2; i < 5; i++)
+                REQUIRE(oldest.try_pop().unwrap() == i);
+            for (int i = 0; i < 3; i++)
+                REQUIRE(newest.try_pop().unwrap() == i);
+            REQUIRE(oldest.try_pop() == co::empty);
+
+            // a parked consumer still gets the value handed over
+            auto consumer = co::thread(
+                [newest]() mutable -> co::func<void>
+                {
+                    auto res = co_await newest.pop();
+                    REQUIRE(res.unwrap() == 10);
+                });
+            co_await co::this_thread::yield();
+            REQUIRE(newest.try_push(10).is_ok());
+            co_await consumer.join();
+            REQUIRE(newest.dropped() == 2);
+
+            // a lossy rendezvous channel drops everything nobody is waiting for
+            co::lossy_channel<int, co::overflow_policy::drop_oldest> rendezvous(0);
+            REQUIRE(rendezvous.try_push(1).is_ok());
+            REQUIRE(rendezvous.dropped() == 1);
+            REQUIRE(rendezvous.try_pop() == co::empty);
+
+            oldest.close();
+            REQUIRE(oldest.try_push(1) == co::closed);
+            REQUIRE(oldest.dropped() == 2);
+        });
+}
+
+TEST_CASE("ts lossy channel never blocks a std::thread producer", "[ts][primitives]")
+{
+    static constexpr int n_items = 100000;
+    co::ts_lossy_channel<int, co::overflow_policy::drop_oldest> ch(16);
+    std::thread producer(
+        [ch]() mutable
+        {
+            for (int i = 0; i < n_items; i++)
+                ch.blocking_push(i).unwrap();
+            ch.close();
+        });
+
+    int n_received = 0;
+    int last = -1;
+    co::loop(
+        [ch, &n_received, &last]() mutable -> co::func<void>
+        {
+            while (true)
+            {
+                auto res = co_await ch.pop();
+                if (res == co::closed)
+                    break;
+                // the order is kept, only some values are missing
+                CO_CHECK(res.unwrap() > last);
+                last = res.unwrap();
+                n_received++;
+            }
+        });
+    producer.join();
+    REQUIRE(last == n_items - 1);
+    REQUIRE(n_received + ch.dropped() == n_items);
+}
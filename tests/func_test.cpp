@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <catch2/catch.hpp>
 #include <co/co.hpp>
 
@@ -75,3 +76,34 @@ TEST_CASE("func unwrap")
             REQUIRE_THROWS_AS((co_await func_err()).unwrap(), co::exception);
         });
 }
+
+TEST_CASE("func frames are recycled", "[core]")
+{
+    auto leaf = [](int i) -> co::func<int> { co_return i; };
+    // the buffer lives across the suspension point, thus it's a part of the frame
+    auto large = [](char c) -> co::func<size_t>
+    {
+        std::array<char, 4 * co::impl::frame_allocator::max_pooled_size> buffer;
+        buffer.fill(c);
+        co_await co::this_thread::sleep_for(std::chrono::milliseconds(0));
+        co_return std::count(buffer.begin(), buffer.end(), c);
+    };
+
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            const auto before = co::get_frame_allocator_stats();
+            int sum = 0;
+            for (int i = 0; i < 100; i++)
+                sum += co_await leaf(i);
+            REQUIRE(sum == 4950);
+            REQUIRE(co_await large('x') == 4 * co::impl::frame_allocator::max_pooled_size);
+
+            const auto after = co::get_frame_allocator_stats();
+            REQUIRE(after.allocations - before.allocations >= 101);
+            REQUIRE(after.deallocations - before.deallocations >= 101);
+            // all the leaf frames except the first one are taken from the free list
+            REQUIRE(after.reused - before.reused >= 99);
+            REQUIRE(after.large_allocations - before.large_allocations >= 1);
+        });
+}
@@ -0,0 +1,176 @@
+#include <thread>
+#include <catch2/catch.hpp>
+#include <co/co.hpp>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+using namespace std::chrono_literals;
+
+TEST_CASE("loop_group spawns co::threads on shards", "[core][ts]")
+{
+    constexpr size_t n_shards = 4;
+    constexpr int n_threads_per_shard = 10;
+    std::vector<std::atomic<int>> counters(n_shards);
+    std::vector<std::thread::id> os_threads(n_shards);
+
+    REQUIRE(co::loop_group::this_shard_id() == std::nullopt);
+    {
+        co::loop_group group(n_shards, /*pin_threads=*/false);
+        REQUIRE(group.size() == n_shards);
+        for (size_t shard = 0; shard < n_shards; shard++)
+        {
+            group
+                .spawn(shard,
+                       [&, shard]() -> co::func<void>
+                       {
+                           CO_CHECK(co::loop_group::this_shard_id() == shard);
+                           os_threads[shard] = std::this_thread::get_id();
+                           std::vector<co::thread> threads;
+                           for (int i = 0; i < n_threads_per_shard; i++)
+                           {
+                               threads.emplace_back(
+                                   [&, shard]() -> co::func<void>
+                                   {
+                                       co_await co::this_thread::sleep_for(1ms);
+                                       // co::threads never leave their shard
+                                       CO_CHECK(co::loop_group::this_shard_id() == shard);
+                                       CO_CHECK(os_threads[shard] == std::this_thread::get_id());
+                                       counters[shard].fetch_add(1);
+                                   });
+                           }
+                           for (auto& thread : threads)
+                               co_await thread.join();
+                       })
+                .detach();
+        }
+        group.join();
+    }
+
+    for (size_t shard = 0; shard < n_shards; shard++)
+    {
+        REQUIRE(counters[shard].load() == n_threads_per_shard);
+        REQUIRE(os_threads[shard] != std::this_thread::get_id());
+    }
+    REQUIRE(co::loop_group::this_shard_id() == std::nullopt);
+}
+
+TEST_CASE("loop_group cross shard communication", "[core][ts]")
+{
+    constexpr int n_messages = 1000;
+    co::loop_group group(2);
+    co::ts_channel<int> ch(10);
+    int sum = 0;
+
+    auto consumer = group.spawn(1,
+                                [ch, &sum]() mutable -> co::func<void>
+                                {
+                                    while (true)
+                                    {
+                                        auto res = co_await ch.pop();
+                                        if (res == co::closed)
+                                            break;
+                                        sum += res.unwrap();
+                                    }
+                                });
+    group
+        .spawn(0,
+               [ch, consumer = std::move(consumer)]() mutable -> co::func<void>
+               {
+                   for (int i = 0; i < n_messages; i++)
+                       co_await ch.push(1).unwrap();
+                   ch.close();
+                   // a co::thread can be joined from another shard
+                   co_await consumer.join();
+               })
+        .detach();
+    group.join();
+
+    REQUIRE(sum == n_messages);
+}
+
+TEST_CASE("loop_group stats are read from another OS thread", "[core][ts]")
+{
+    co::loop_group group(2, /*pin_threads=*/false);
+    co::ts_event started;
+    co::ts_event stop;
+    group
+        .spawn(1,
+               [&]() -> co::func<void>
+               {
+                   started.notify();
+                   co_await stop.wait();
+               })
+        .detach();
+
+    started.blocking_wait();
+    const auto stats = group.stats(1);
+    REQUIRE(stats.threads_alive == 1);
+    REQUIRE(stats.iterations > 0);
+    REQUIRE(group.stats(0).threads_started == 0);
+
+    stop.notify();
+    group.join();
+}
+
+#if defined(__linux__)
+TEST_CASE("loop_group pins shards only to the allowed cores", "[core][ts]")
+{
+    constexpr size_t n_shards = 3;
+    // Catch2 isn't thread safe, the results are checked after the OS thread is joined
+    bool restricted_ok = false;
+    int allowed = -1;
+    std::vector<std::atomic<int>> cpus(n_shards);
+    std::vector<std::optional<size_t>> pinned_cores(n_shards);
+
+    // restrict the OS thread creating the group to one core, as taskset or a cgroup cpuset would do
+    std::thread restricted(
+        [&]()
+        {
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+                return;
+            for (int core = CPU_SETSIZE - 1; core >= 0 && allowed < 0; core--)
+            {
+                if (CPU_ISSET(core, &cpu_set))
+                    allowed = core;
+            }
+            if (allowed < 0)
+                return;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(allowed, &cpu_set);
+            if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+                return;
+            restricted_ok = true;
+
+            co::loop_group group(n_shards);
+            for (size_t shard = 0; shard < n_shards; shard++)
+            {
+                pinned_cores[shard] = group.pinned_core(shard);
+                group
+                    .spawn(shard,
+                           [&cpus, shard]() -> co::func<void>
+                           {
+                               cpus[shard] = sched_getcpu();
+                               co_return;
+                           })
+                    .detach();
+            }
+            group.join();
+        });
+    restricted.join();
+
+    REQUIRE(restricted_ok);
+    for (size_t shard = 0; shard < n_shards; shard++)
+    {
+        REQUIRE(pinned_cores[shard] == size_t(allowed));
+        REQUIRE(cpus[shard].load() == allowed);
+    }
+
+    co::loop_group unpinned(1, /*pin_threads=*/false);
+    REQUIRE(!unpinned.pinned_core(0));
+    unpinned.join();
+}
+#endif
@@ -0,0 +1,405 @@
+#include <mutex>
+#include <set>
+#include <thread>
+#include <catch2/catch.hpp>
+#include <co/co.hpp>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+void busy_wait(std::chrono::steady_clock::duration duration)
+{
+    const auto deadline = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < deadline)
+    {}
+}
+
+}  // namespace
+
+TEST_CASE("multi worker loop steals co::threads", "[core][ts]")
+{
+    constexpr size_t n_workers = 4;
+    constexpr int n_threads = 64;
+    std::mutex mutex;
+    std::set<std::thread::id> os_threads;
+    std::atomic<int> counter = 0;
+
+    co::loop(n_workers,
+             [&]() -> co::func<void>
+             {
+                 std::vector<co::thread> threads;
+                 for (int i = 0; i < n_threads; i++)
+                 {
+                     threads.emplace_back(
+                         [&]() -> co::func<void>
+                         {
+                             busy_wait(1ms);
+                             {
+                                 std::unique_lock lk(mutex);
+                                 os_threads.insert(std::this_thread::get_id());
+                             }
+                             co_await co::this_thread::sleep_for(1ms);
+                             counter.fetch_add(1);
+                         });
+                 }
+                 for (auto& thread : threads)
+                     co_await thread.join();
+             });
+
+    REQUIRE(counter.load() == n_threads);
+    REQUIRE(os_threads.size() > 1);
+    REQUIRE(os_threads.size() <= n_workers);
+}
+
+TEST_CASE("multi worker loop with detached co::threads", "[core][ts]")
+{
+    std::atomic<int> counter = 0;
+    for (int run = 0; run < 3; run++)
+    {
+        co::loop(2,
+                 [&]() -> co::func<void>
+                 {
+                     for (int i = 0; i < 100; i++)
+                     {
+                         co::thread(
+                             [&]() -> co::func<void>
+                             {
+                                 co_await co::this_thread::sleep_for(1ms);
+                                 counter.fetch_add(1);
+                             })
+                             .detach();
+                     }
+                     co_return;
+                 });
+    }
+    REQUIRE(counter.load() == 300);
+
+    // the classic single threaded loop still works in the same OS thread
+    co::loop([&]() -> co::func<void> { co_await co::this_thread::sleep_for(1ms); });
+}
+
+TEST_CASE("co::thread name and stop source are created on demand", "[core]")
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            auto named = co::thread(
+                []() -> co::func<void>
+                {
+                    REQUIRE(co::this_thread::name() == "worker");
+                    co_return;
+                },
+                "worker");
+            auto unnamed = co::thread(
+                []() -> co::func<void>
+                {
+                    REQUIRE(co::this_thread::name().starts_with("co::thread"));
+                    co_return;
+                });
+            co_await named.join();
+            co_await unnamed.join();
+
+            // the stop request is visible even if it's done before the co::thread is started
+            auto stopped = co::thread(
+                []() -> co::func<void>
+                {
+                    REQUIRE(co::this_thread::stop_requested());
+                    auto res = co_await co::this_thread::sleep_for(1s, co::this_thread::stop_token());
+                    REQUIRE(res == co::cancel);
+                });
+            stopped.request_stop();
+            co_await stopped.join();
+        });
+}
+
+TEST_CASE("co::thread stop requested from another OS thread under a multi-worker loop", "[core]")
+{
+    static constexpr size_t n_threads = 200;
+    std::atomic<size_t> n_cancelled = 0;
+    co::loop(4,
+             [&n_cancelled]() -> co::func<void>
+             {
+                 std::vector<co::thread> threads;
+                 for (size_t i = 0; i < n_threads; i++)
+                 {
+                     threads.emplace_back(
+                         [&n_cancelled]() -> co::func<void>
+                         {
+                             // the stop state may be created here or by request_stop(), both must share it
+                             auto res = co_await co::this_thread::sleep_for(10s, co::this_thread::stop_token());
+                             if (res == co::cancel)
+                                 n_cancelled++;
+                         });
+                 }
+
+                 // the co::threads are started by the other workers while the stops are requested
+                 std::thread stopper(
+                     [&threads]()
+                     {
+                         for (auto& th : threads)
+                             th.request_stop();
+                     });
+                 stopper.join();
+                 for (auto& th : threads)
+                     co_await th.join();
+             });
+    REQUIRE(n_cancelled.load() == n_threads);
+}
+
+TEST_CASE("yield resumes other co::threads first", "[core]")
+{
+    std::vector<int> order;
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            auto th = co::thread(
+                [&]() -> co::func<void>
+                {
+                    order.push_back(1);
+                    co_return;
+                });
+            co_await co::this_thread::yield();
+            order.push_back(2);
+            co_await th.join();
+        });
+    REQUIRE(order == std::vector<int>{ 1, 2 });
+}
+
+TEST_CASE("co::thread which never waits doesn't starve timers", "[core]")
+{
+    bool stop = false;
+    size_t n_iterations = 0;
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            auto timer = co::thread(
+                [&]() -> co::func<void>
+                {
+                    co_await co::this_thread::sleep_for(5ms);
+                    stop = true;
+                });
+
+            // the channel always has space and values, so push() and pop() never suspend
+            co::channel<int> ch(10);
+            co::mutex mutex;
+            co::event ev;
+            ev.notify();
+            while (!stop)
+            {
+                (co_await ch.push(1)).unwrap();
+                (co_await ch.pop()).unwrap();
+                co_await mutex.lock();
+                mutex.unlock();
+                (co_await ev.wait({ 1s })).unwrap();
+                n_iterations++;
+            }
+            co_await timer.join();
+        });
+    REQUIRE(n_iterations > 0);
+}
+
+TEST_CASE("co::threads which keep waking each other don't starve timers", "[core]")
+{
+    // bounds the test if the timer is starved
+    static constexpr int max_round_trips = 1'000'000;
+    bool stop = false;
+    int n_round_trips = 0;
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            auto timer = co::thread(
+                [&]() -> co::func<void>
+                {
+                    co_await co::this_thread::sleep_for(1ms);
+                    stop = true;
+                });
+
+            // every pop() suspends and the push() of the other side wakes it up, so there is always a ready co::thread
+            co::channel<int> ping(1);
+            co::channel<int> pong(1);
+            auto ponger = co::thread(
+                [&]() -> co::func<void>
+                {
+                    while (true)
+                    {
+                        auto res = co_await ping.pop();
+                        if (res == co::closed)
+                            break;
+                        (co_await pong.push(res.unwrap())).unwrap();
+                    }
+                });
+            while (!stop && n_round_trips < max_round_trips)
+            {
+                (co_await ping.push(n_round_trips)).unwrap();
+                (co_await pong.pop()).unwrap();
+                n_round_trips++;
+            }
+            ping.close();
+            co_await ponger.join();
+            co_await timer.join();
+        });
+    REQUIRE(n_round_trips < max_round_trips);
+}
+
+TEST_CASE("co::thread woken up by a running co::thread runs next", "[core]")
+{
+    std::vector<int> order;
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            co::event ev;
+            auto waiter = co::thread(
+                [&]() -> co::func<void>
+                {
+                    co_await ev.wait();
+                    order.push_back(0);
+                });
+            // let the waiter start waiting
+            co_await co::this_thread::yield();
+
+            auto th1 = co::thread(
+                [&]() -> co::func<void>
+                {
+                    order.push_back(1);
+                    co_return;
+                });
+            auto th2 = co::thread(
+                [&]() -> co::func<void>
+                {
+                    order.push_back(2);
+                    co_return;
+                });
+            // the waiter goes ahead of the already queued th1 and th2
+            ev.notify();
+            co_await th1.join();
+            co_await th2.join();
+            co_await waiter.join();
+        });
+    REQUIRE(order == std::vector<int>{ 0, 1, 2 });
+}
+
+TEST_CASE("co::threads of higher priority classes run first", "[core]")
+{
+    std::vector<co::priority> order;
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            std::vector<co::thread> threads;
+            for (auto priority : { co::priority::low, co::priority::normal, co::priority::high })
+            {
+                threads.emplace_back(
+                    [&]() -> co::func<void>
+                    {
+                        order.push_back(co::this_thread::priority());
+                        co_return;
+                    },
+                    "",
+                    priority);
+            }
+            for (auto& th : threads)
+                co_await th.join();
+        });
+    REQUIRE(order == std::vector<co::priority>{ co::priority::high, co::priority::normal, co::priority::low });
+}
+
+TEST_CASE("priority weights share the loop between busy classes", "[core]")
+{
+    constexpr int n_rounds = 100;
+    std::array<int, co::impl::n_priorities> resumes{};
+    co::set_priority_weights(4, 2, 1);
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            bool stop = false;
+            std::vector<co::thread> threads;
+            for (auto priority : { co::priority::low, co::priority::normal, co::priority::high })
+            {
+                threads.emplace_back(
+                    [&, priority]() -> co::func<void>
+                    {
+                        while (!stop)
+                        {
+                            // the low class stops the run, the busy classes never let the event loop iterate
+                            if (++resumes[co::impl::priority_index(priority)] >= n_rounds &&
+                                priority == co::priority::low)
+                                stop = true;
+                            // wake up a helper co::thread, so the class always has a ready co::thread
+                            co::event ev;
+                            auto helper = co::thread(
+                                [&ev]() -> co::func<void>
+                                {
+                                    ev.notify();
+                                    co_return;
+                                },
+                                "",
+                                priority);
+                            co_await ev.wait();
+                            co_await helper.join();
+                        }
+                    },
+                    "",
+                    priority);
+            }
+            for (auto& th : threads)
+                co_await th.join();
+        });
+    co::set_priority_weights(8, 4, 1);
+
+    const auto high = resumes[co::impl::priority_index(co::priority::high)];
+    const auto normal = resumes[co::impl::priority_index(co::priority::normal)];
+    const auto low = resumes[co::impl::priority_index(co::priority::low)];
+    REQUIRE(high > normal);
+    REQUIRE(normal > low);
+    REQUIRE(low >= n_rounds);
+}
+
+TEST_CASE("loop stats", "[core]")
+{
+    constexpr int n_threads = 10;
+    const auto before = co::get_loop_stats();
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            std::vector<co::thread> threads;
+            for (int i = 0; i < n_threads; i++)
+                threads.emplace_back([]() -> co::func<void> { co_await co::this_thread::sleep_for(5ms); });
+
+            // the co::threads are alive until they are joined
+            co_await co::this_thread::yield();
+            const auto stats = co::get_loop_stats();
+            REQUIRE(stats.threads_alive - before.threads_alive == n_threads + 1);
+
+            // wake up from another OS thread
+            co::ts_event ev;
+            std::thread notifier(
+                [&ev]()
+                {
+                    // let the co::thread suspend first
+                    std::this_thread::sleep_for(10ms);
+                    ev.notify();
+                });
+            co_await ev.wait();
+            notifier.join();
+
+            // keep the event loop busy for a while
+            busy_wait(2ms);
+            for (auto& th : threads)
+                co_await th.join();
+        });
+    const auto after = co::get_loop_stats();
+
+    REQUIRE(after.threads_started - before.threads_started == n_threads + 1);
+    REQUIRE(after.threads_finished - before.threads_finished == n_threads + 1);
+    REQUIRE(after.threads_alive == before.threads_alive);
+    REQUIRE(after.remote_wakeups - before.remote_wakeups == 1);
+    REQUIRE(after.iterations > before.iterations);
+    REQUIRE(after.resumes - before.resumes >= 2 * n_threads);
+    REQUIRE(after.ready_depth.max >= n_threads);
+    REQUIRE(after.drain_time.count > before.drain_time.count);
+    // the event loop was blocked in the poll phase while the co::threads slept
+    REQUIRE(after.poll_time.sum - before.poll_time.sum >= uint64_t(std::chrono::nanoseconds(2ms).count()));
+    REQUIRE(after.loop_lag.max >= uint64_t(std::chrono::nanoseconds(2ms).count()));
+    REQUIRE(after.loop_lag.percentile(1.0) == after.loop_lag.max);
+}
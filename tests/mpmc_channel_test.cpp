@@ -0,0 +1,127 @@
+#include <atomic>
+#include <thread>
+#include <catch2/catch.hpp>
+#include <co/co.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("mpmc_channel with capacity 1 wakes up parked co::threads", "[primitives]")
+{
+    int sum = 0;
+    co::loop(
+        [&sum]() -> co::func<void>
+        {
+            co::mpmc_channel<int> ch(1);
+            std::vector<co::thread> consumers;
+            for (int i = 0; i < 3; i++)
+            {
+                consumers.emplace_back(
+                    [ch, &sum]() mutable -> co::func<void>
+                    {
+                        while (true)
+                        {
+                            auto res = co_await ch.pop();
+                            if (res == co::closed)
+                                break;
+                            sum += res.unwrap();
+                        }
+                    });
+            }
+            co_await co::this_thread::sleep_for(1ms);
+            for (int i = 1; i <= 100; i++)
+                (co_await ch.push(i)).unwrap();
+            ch.close();
+            for (auto& consumer : consumers)
+                co_await consumer.join();
+        });
+    REQUIRE(sum == 5050);
+}
+
+TEST_CASE("mpmc_channel from many std::threads to many co::threads", "[ts][primitives]")
+{
+    constexpr int n_producers = 8;
+    constexpr int n_items = 20000;
+    co::mpmc_channel<int> ch(16);
+    std::atomic<int> n_done = 0;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < n_producers; p++)
+    {
+        producers.emplace_back(
+            [ch, &n_done]() mutable
+            {
+                for (int i = 1; i <= n_items; i++)
+                    ch.blocking_push(i).unwrap();
+                if (++n_done == n_producers)
+                    ch.close();
+            });
+    }
+
+    std::atomic<int64_t> sum = 0;
+    co::loop(4,
+             [ch, &sum]() mutable -> co::func<void>
+             {
+                 std::vector<co::thread> consumers;
+                 for (int i = 0; i < 8; i++)
+                 {
+                     consumers.emplace_back(
+                         [ch, &sum]() mutable -> co::func<void>
+                         {
+                             int64_t local_sum = 0;
+                             while (true)
+                             {
+                                 auto res = co_await ch.pop();
+                                 if (res == co::closed)
+                                     break;
+                                 local_sum += res.unwrap();
+                             }
+                             sum += local_sum;
+                         });
+                 }
+                 for (auto& consumer : consumers)
+                     co_await consumer.join();
+             });
+    for (auto& producer : producers)
+        producer.join();
+    REQUIRE(sum == int64_t(n_producers) * n_items * (n_items + 1) / 2);
+}
+
+TEST_CASE("mpmc_channel from co::threads to many std::threads", "[ts][primitives]")
+{
+    constexpr int n_consumers = 4;
+    constexpr int n_items = 50000;
+    co::mpmc_channel<int> ch(8);
+    std::atomic<int64_t> sum = 0;
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < n_consumers; c++)
+    {
+        consumers.emplace_back(
+            [ch, &sum]() mutable
+            {
+                while (true)
+                {
+                    auto res = ch.blocking_pop();
+                    if (res == co::closed)
+                        break;
+                    sum += res.unwrap();
+                }
+            });
+    }
+
+    co::loop(
+        [ch]() mutable -> co::func<void>
+        {
+            auto producer = [ch](int from) mutable -> co::func<void>
+            {
+                for (int i = from; i <= n_items; i += 2)
+                    (co_await ch.push(i)).unwrap();
+            };
+            auto even = co::thread(producer(2));
+            auto odd = co::thread(producer(1));
+            co_await even.join();
+            co_await odd.join();
+            ch.close();
+        });
+    for (auto& consumer : consumers)
+        consumer.join();
+    REQUIRE(sum == int64_t(n_items) * (n_items + 1) / 2);
+}
@@ -221,4 +221,44 @@ TEST_CASE("mutex adopt", "[primitives]")
             }
             REQUIRE(mutex.is_locked() == false);
         });
-}
\ No newline at end of file
+}
+
+TEST_CASE("mutex contended lock doesn't allocate", "[primitives]")
+{
+    constexpr int n_iterations = 1000;
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::mutex mutex;
+            int counter = 0;
+            co_await mutex.lock();
+            auto th = co::thread(
+                [&]() -> co::func<void>
+                {
+                    for (int i = 0; i < n_iterations; i++)
+                    {
+                        co_await mutex.lock();
+                        counter++;
+                        mutex.unlock();
+                    }
+                });
+            // let the co::thread start and wait for the lock
+            co_await co::this_thread::yield();
+
+            const auto before = co::get_frame_allocator_stats();
+            for (int i = 0; i < n_iterations; i++)
+            {
+                // the lock is passed to the waiting co::thread
+                mutex.unlock();
+                auto res = co_await mutex.lock({ 1s });
+                REQUIRE(res.is_ok());
+                counter++;
+            }
+            const auto after = co::get_frame_allocator_stats();
+            REQUIRE(after.allocations == before.allocations);
+            mutex.unlock();
+
+            co_await th.join();
+            REQUIRE(counter == 2 * n_iterations);
+        });
+}
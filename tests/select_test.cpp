@@ -0,0 +1,213 @@
+#include <optional>
+#include <string>
+#include <thread>
+#include <catch2/catch.hpp>
+#include <co/co.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("select takes the first ready channel", "[primitives]")
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::channel<int> numbers(2);
+            co::channel<std::string> texts(2);
+            std::optional<int> number;
+            std::optional<std::string> text;
+
+            REQUIRE(texts.try_push("a").is_ok());
+            auto res = co_await co::select(co::recv(numbers, number), co::recv(texts, text));
+            REQUIRE(res.unwrap() == 1);
+            REQUIRE(text == "a");
+            REQUIRE(!number);
+
+            // both are ready, the argument order decides
+            REQUIRE(numbers.try_push(1).is_ok());
+            REQUIRE(texts.try_push("b").is_ok());
+            res = co_await co::select(co::recv(numbers, number), co::recv(texts, text));
+            REQUIRE(res.unwrap() == 0);
+            REQUIRE(number == 1);
+            REQUIRE(texts.try_pop().unwrap() == "b");
+        });
+}
+
+TEST_CASE("select waits for a value pushed by another co::thread", "[primitives]")
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::channel<int> first(1);
+            co::channel<int> second(0);
+            auto producer = co::thread(
+                [second]() mutable -> co::func<void>
+                {
+                    co_await co::this_thread::sleep_for(5ms);
+                    (co_await second.push(42)).unwrap();
+                });
+
+            std::optional<int> a;
+            std::optional<int> b;
+            auto res = co_await co::select(co::recv(first, a), co::recv(second, b));
+            REQUIRE(res.unwrap() == 1);
+            REQUIRE(b == 42);
+            REQUIRE(!a);
+            co_await producer.join();
+
+            // the parked slots are gone, the next values go to the buffer of the first channel
+            REQUIRE(first.try_push(1).is_ok());
+            REQUIRE(first.try_pop().unwrap() == 1);
+        });
+}
+
+TEST_CASE("select pops exactly one value when several producers come at once", "[primitives]")
+{
+    static constexpr int n_rounds = 100;
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::channel<int> first(1);
+            co::channel<int> second(1);
+            for (int i = 0; i < n_rounds; i++)
+            {
+                auto producer = co::thread(
+                    [first, second]() mutable -> co::func<void>
+                    {
+                        REQUIRE(first.try_push(1).is_ok());
+                        REQUIRE(second.try_push(2).is_ok());
+                        co_return;
+                    });
+
+                std::optional<int> a;
+                std::optional<int> b;
+                auto res = co_await co::select(co::recv(first, a), co::recv(second, b));
+                co_await producer.join();
+
+                // the value of the other channel stays in its buffer
+                if (res.unwrap() == 0)
+                {
+                    REQUIRE((a == 1 && !b));
+                    REQUIRE(second.try_pop().unwrap() == 2);
+                }
+                else
+                {
+                    REQUIRE((b == 2 && !a));
+                    REQUIRE(first.try_pop().unwrap() == 1);
+                }
+                REQUIRE(first.try_pop() == co::empty);
+                REQUIRE(second.try_pop() == co::empty);
+            }
+        });
+}
+
+TEST_CASE("select on events, closed channels and interruptions", "[primitives]")
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::channel<int> ch(1);
+            std::optional<int> value = 7;
+            co::event stop;
+
+            auto res = co_await co::select(co::until(5ms), co::recv(ch, value), stop);
+            REQUIRE(res == co::timeout);
+
+            // the event can be waited again after the select
+            auto notifier = co::thread(
+                [&stop]() -> co::func<void>
+                {
+                    co_await co::this_thread::sleep_for(5ms);
+                    stop.notify();
+                });
+            res = co_await co::select(co::recv(ch, value), stop);
+            REQUIRE(res.unwrap() == 1);
+            REQUIRE(stop.is_notified());
+            co_await notifier.join();
+
+            co::event other;
+            auto closer = co::thread(
+                [ch]() mutable -> co::func<void>
+                {
+                    co_await co::this_thread::sleep_for(5ms);
+                    ch.close();
+                });
+            res = co_await co::select(co::recv(ch, value), other);
+            REQUIRE(res.unwrap() == 0);
+            REQUIRE(!value);
+            co_await closer.join();
+
+            co::stop_source stop_source;
+            stop_source.request_stop();
+            res = co_await co::select(stop_source.get_token(), other);
+            REQUIRE(res == co::cancel);
+        });
+}
+
+TEST_CASE("select on ts channels and a ts_event fed by std::threads", "[primitives]")
+{
+    static constexpr int n_items = 1000;
+    co::ts_channel<int> first(4);
+    co::ts_channel<int> second(4);
+    co::ts_event done;
+    std::thread producer1(
+        [first]() mutable
+        {
+            for (int i = 0; i < n_items; i++)
+                first.blocking_push(i).unwrap();
+        });
+    std::thread producer2(
+        [second, &done]() mutable
+        {
+            for (int i = 0; i < n_items; i++)
+                second.blocking_push(i).unwrap();
+            done.notify();
+        });
+
+    int sum1 = 0;
+    int sum2 = 0;
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            int n_received = 0;
+            std::optional<int> a;
+            std::optional<int> b;
+            bool done_seen = false;
+            while (n_received < 2 * n_items)
+            {
+                auto res = co_await co::select(co::recv(first, a), co::recv(second, b), done);
+                switch (res.unwrap())
+                {
+                case 0:
+                    sum1 += *a;
+                    n_received++;
+                    break;
+                case 1:
+                    sum2 += *b;
+                    n_received++;
+                    break;
+                case 2:
+                    done_seen = true;
+                    // the event stays notified, drain the channels without it
+                    while (n_received < 2 * n_items)
+                    {
+                        auto res2 = co_await co::select(co::recv(first, a), co::recv(second, b));
+                        if (res2.unwrap() == 0)
+                            sum1 += *a;
+                        else
+                            sum2 += *b;
+                        n_received++;
+                    }
+                    break;
+                }
+            }
+            if (!done_seen)
+            {
+                auto res = co_await co::select(done);
+                REQUIRE(res.unwrap() == 0);
+            }
+        });
+    producer1.join();
+    producer2.join();
+    REQUIRE(sum1 == n_items * (n_items - 1) / 2);
+    REQUIRE(sum2 == n_items * (n_items - 1) / 2);
+}
@@ -0,0 +1,245 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <catch2/catch.hpp>
+#include <co/co.hpp>
+
+using namespace std::chrono_literals;
+
+// the cases shared by spsc_channel and mpmc_channel, the multi producer ones are in mpmc_channel_test.cpp
+TEMPLATE_TEST_CASE("lock free channel keeps the order between co::threads",
+                   "[primitives]",
+                   co::spsc_channel<int>,
+                   co::mpmc_channel<int>)
+{
+    constexpr int n_items = 1000;
+    std::vector<int> received;
+    co::loop(
+        [&received]() -> co::func<void>
+        {
+            TestType ch(3);
+            auto producer = co::thread(
+                [ch]() mutable -> co::func<void>
+                {
+                    for (int i = 0; i < n_items; i++)
+                        co_await ch.push(i).unwrap();
+                    ch.close();
+                });
+            while (true)
+            {
+                auto res = co_await ch.pop();
+                if (res == co::closed)
+                    break;
+                received.push_back(res.unwrap());
+            }
+            co_await producer.join();
+        });
+    REQUIRE(received.size() == n_items);
+    for (int i = 0; i < n_items; i++)
+        REQUIRE(received[i] == i);
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("lock free channel try operations and interruptions",
+                           "[primitives]",
+                           (co::spsc_channel, co::mpmc_channel),
+                           (std::string))
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            TestType ch(2);
+            REQUIRE(ch.try_pop() == co::empty);
+            REQUIRE(ch.try_push("a").is_ok());
+            REQUIRE(ch.try_push(std::string("b")).is_ok());
+            REQUIRE(ch.try_push("c") == co::full);
+            const auto push_res = co_await ch.push("c", { 5ms });
+            REQUIRE(push_res == co::timeout);
+
+            REQUIRE(ch.try_pop().unwrap() == "a");
+            auto pop_res = co_await ch.pop();
+            REQUIRE(pop_res.unwrap() == "b");
+            pop_res = co_await ch.pop({ 5ms });
+            REQUIRE(pop_res == co::timeout);
+
+            co::stop_source stop;
+            auto waiter = co::thread(
+                [ch, token = stop.get_token()]() mutable -> co::func<void>
+                {
+                    const auto res = co_await ch.pop(token);
+                    REQUIRE(res == co::cancel);
+                });
+            co_await co::this_thread::sleep_for(1ms);
+            stop.request_stop();
+            co_await waiter.join();
+
+            // the items pushed before closing are still delivered
+            REQUIRE(ch.try_push("d").is_ok());
+            ch.close();
+            REQUIRE(ch.is_closed());
+            REQUIRE(ch.try_push("e") == co::closed);
+            const auto closed_push_res = co_await ch.push("e");
+            REQUIRE(closed_push_res == co::closed);
+            pop_res = co_await ch.pop();
+            REQUIRE(pop_res.unwrap() == "d");
+            pop_res = co_await ch.pop();
+            REQUIRE(pop_res == co::closed);
+        });
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("lock free channel destroys items left in the ring",
+                           "[primitives]",
+                           (co::spsc_channel, co::mpmc_channel),
+                           (std::shared_ptr<int>))
+{
+    auto item = std::make_shared<int>(1);
+    {
+        TestType ch(3);
+        for (int i = 0; i < 4; i++)
+        {
+            REQUIRE(ch.try_push(item).is_ok());
+            REQUIRE(ch.try_pop().is_ok());
+        }
+        REQUIRE(ch.try_push(item).is_ok());
+        REQUIRE(ch.try_push(item).is_ok());
+        REQUIRE(item.use_count() == 3);
+    }
+    REQUIRE(item.use_count() == 1);
+}
+
+TEMPLATE_TEST_CASE("lock free channel blocking operations time out",
+                   "[ts][primitives]",
+                   co::spsc_channel<int>,
+                   co::mpmc_channel<int>)
+{
+    TestType ch(1);
+    REQUIRE(ch.blocking_pop(1ms) == co::timeout);
+    REQUIRE(ch.blocking_push(1).is_ok());
+    REQUIRE(ch.blocking_push(2, 1ms) == co::timeout);
+    REQUIRE(ch.blocking_pop().unwrap() == 1);
+    ch.close();
+    REQUIRE(ch.blocking_pop() == co::closed);
+}
+
+TEMPLATE_TEST_CASE("lock free channel push racing with close never loses an accepted value",
+                   "[ts][primitives]",
+                   co::spsc_channel<int>,
+                   co::mpmc_channel<int>)
+{
+    static constexpr int n_rounds = 200;
+    // spsc_channel allows only one producer
+    static constexpr int n_producers = std::is_same_v<TestType, co::spsc_channel<int>> ? 1 : 2;
+    for (int round = 0; round < n_rounds; round++)
+    {
+        TestType ch(4);
+        std::atomic<int> n_accepted = 0;
+        std::vector<std::thread> producers;
+        for (int i = 0; i < n_producers; i++)
+        {
+            producers.emplace_back(
+                [ch, &n_accepted]() mutable
+                {
+                    for (int value = 0;; value++)
+                    {
+                        auto res = ch.try_push(value);
+                        if (res == co::closed)
+                            break;
+                        if (res.is_ok())
+                            n_accepted++;
+                    }
+                });
+        }
+        std::thread closer(
+            [ch, round]() mutable
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(round % 50));
+                ch.close();
+            });
+
+        int n_received = 0;
+        while (ch.blocking_pop().is_ok())
+            n_received++;
+        closer.join();
+        for (auto& producer : producers)
+            producer.join();
+        // every co::ok push is popped, a push which has got co::closed is never popped
+        REQUIRE(n_received == n_accepted.load());
+    }
+}
+
+TEST_CASE("spsc_channel wakes up a parked consumer", "[primitives]")
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::spsc_channel<int> ch(1);
+            auto consumer = co::thread(
+                [ch]() mutable -> co::func<void>
+                {
+                    auto res = co_await ch.pop();
+                    REQUIRE(res.unwrap() == 42);
+                });
+            co_await co::this_thread::sleep_for(1ms);
+            REQUIRE(ch.try_push(42).is_ok());
+            co_await consumer.join();
+        });
+}
+
+TEST_CASE("spsc_channel from a std::thread to a co::thread", "[ts][primitives]")
+{
+    constexpr int n_items = 100000;
+    co::spsc_channel<int> ch(16);
+    std::thread producer(
+        [ch]() mutable
+        {
+            for (int i = 0; i < n_items; i++)
+                ch.blocking_push(i).unwrap();
+            ch.close();
+        });
+
+    int expected = 0;
+    co::loop(
+        [ch, &expected]() mutable -> co::func<void>
+        {
+            while (true)
+            {
+                auto res = co_await ch.pop();
+                if (res == co::closed)
+                    break;
+                CO_CHECK(res.unwrap() == expected);
+                expected++;
+            }
+        });
+    producer.join();
+    REQUIRE(expected == n_items);
+}
+
+TEST_CASE("spsc_channel from a co::thread to a std::thread", "[ts][primitives]")
+{
+    constexpr int n_items = 100000;
+    co::spsc_channel<int> ch(16);
+    int expected = 0;
+    std::thread consumer(
+        [ch, &expected]() mutable
+        {
+            while (true)
+            {
+                auto res = ch.blocking_pop();
+                if (res == co::closed)
+                    break;
+                CO_CHECK(res.unwrap() == expected);
+                expected++;
+            }
+        });
+
+    co::loop(
+        [ch]() mutable -> co::func<void>
+        {
+            for (int i = 0; i < n_items; i++)
+                (co_await ch.push(i)).unwrap();
+            ch.close();
+        });
+    consumer.join();
+    REQUIRE(expected == n_items);
+}
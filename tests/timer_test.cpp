@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <catch2/catch.hpp>
+#include <co/co.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("timers are fired in order", "[core]")
+{
+    // the timeouts cover several levels of the timer wheel
+    const std::vector<std::chrono::milliseconds> timeouts = { 130ms, 1ms, 65ms, 64ms, 5ms, 63ms, 0ms, 200ms };
+    std::vector<std::chrono::milliseconds> fired;
+
+    const auto start = std::chrono::steady_clock::now();
+    co::loop(
+        [&]() -> co::func<void>
+        {
+            std::vector<co::thread> threads;
+            for (auto timeout : timeouts)
+            {
+                threads.emplace_back(
+                    [&, timeout]() -> co::func<void>
+                    {
+                        const auto thread_start = std::chrono::steady_clock::now();
+                        co_await co::this_thread::sleep_for(timeout);
+                        REQUIRE(std::chrono::steady_clock::now() - thread_start >= timeout - 1ms);
+                        fired.push_back(timeout);
+                    });
+            }
+            for (auto& th : threads)
+                co_await th.join();
+        });
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    auto expected = timeouts;
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(fired == expected);
+    // the event loop time has millisecond granularity
+    REQUIRE(elapsed >= 199ms);
+    REQUIRE(elapsed < 500ms);
+}
+
+TEST_CASE("cancelled timers don't keep the loop alive", "[core]")
+{
+    const auto start = std::chrono::steady_clock::now();
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::event ev;
+            auto th = co::thread(
+                [&]() -> co::func<void>
+                {
+                    auto res = co_await ev.wait({ 10s });
+                    REQUIRE(res.is_ok());
+                });
+            co_await co::this_thread::sleep_for(1ms);
+            ev.notify();
+            co_await th.join();
+
+            // stopped before the timeout
+            co::stop_source stop;
+            auto sleeper = co::thread(
+                [token = stop.get_token()]() -> co::func<void>
+                {
+                    auto res = co_await co::this_thread::sleep_for(1h, token);
+                    REQUIRE(res == co::cancel);
+                });
+            co_await co::this_thread::sleep_for(1ms);
+            stop.request_stop();
+            co_await sleeper.join();
+        });
+    REQUIRE(std::chrono::steady_clock::now() - start < 1s);
+}
+
+TEST_CASE("timers coalescing slack", "[core]")
+{
+    co::set_timer_slack(20ms);
+    co::loop(
+        []() -> co::func<void>
+        {
+            // wake up at the slack boundary, so both of the timers below fall into the next slack interval
+            co_await co::this_thread::sleep_for(1ms);
+            auto th1 = co::thread([]() -> co::func<void> { co_await co::this_thread::sleep_for(3ms); });
+            auto th2 = co::thread([]() -> co::func<void> { co_await co::this_thread::sleep_for(7ms); });
+            const auto start = std::chrono::steady_clock::now();
+            co_await th1.join();
+            const auto first = std::chrono::steady_clock::now() - start;
+            co_await th2.join();
+            const auto second = std::chrono::steady_clock::now() - start;
+            // both of timers are expired at the same slack boundary
+            REQUIRE(second - first < 2ms);
+        });
+    co::set_timer_slack(0ms);
+}
+
+TEST_CASE("loop clock is cached during the loop iteration", "[core]")
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            const auto cached = co::loop_clock::now();
+            std::this_thread::sleep_for(5ms);
+            REQUIRE(co::loop_clock::now() == cached);
+            REQUIRE(co::loop_clock::update() >= cached + 5ms);
+
+            co_await co::this_thread::sleep_for(10ms);
+            const auto diff = std::chrono::steady_clock::now() - co::loop_clock::now();
+            REQUIRE(diff > -1ms);
+            REQUIRE(diff < 5ms);
+
+            // the deadline is counted from the cached time
+            const auto deadline = co::loop_clock::now() + 20ms;
+            std::this_thread::sleep_for(5ms);
+            REQUIRE(co::until(deadline).milliseconds() == 20);
+        });
+}
+
+TEST_CASE("precise loop clock", "[core]")
+{
+    co::set_precise_loop_clock(true);
+    co::loop(
+        []() -> co::func<void>
+        {
+            const auto start = co::loop_clock::now();
+            std::this_thread::sleep_for(5ms);
+            REQUIRE(co::loop_clock::now() >= start + 5ms);
+            co_return;
+        });
+    co::set_precise_loop_clock(false);
+}
+
+TEST_CASE("sub millisecond timers", "[core]")
+{
+    co::set_timer_resolution(10us);
+    co::loop(
+        []() -> co::func<void>
+        {
+            for (auto timeout : { 200us, 50us, 1500us })
+            {
+                // the best of a few runs filters out the OS scheduling noise, no run may fire early though
+                auto best = std::chrono::steady_clock::duration::max();
+                for (int i = 0; i < 5; i++)
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    co_await co::this_thread::sleep_for(timeout);
+                    const auto elapsed = std::chrono::steady_clock::now() - start;
+                    REQUIRE(elapsed >= timeout);
+                    best = std::min(best, elapsed);
+                }
+                REQUIRE(best < timeout + 2ms);
+            }
+
+            co::event ev;
+            const auto res = co_await ev.wait(co::loop_clock::now() + 300us);
+            REQUIRE(res == co::timeout);
+
+            // cancelled timers don't keep the loop alive
+            co::event notified;
+            auto notifier = co::thread(
+                [&notified]() -> co::func<void>
+                {
+                    notified.notify();
+                    co_return;
+                });
+            const auto notified_res = co_await notified.wait({ 10s });
+            REQUIRE(notified_res.is_ok());
+            co_await notifier.join();
+        });
+    co::set_timer_resolution(1ms);
+}
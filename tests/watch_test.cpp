@@ -0,0 +1,152 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <co/co.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("watch delivers only the latest version", "[primitives]")
+{
+    co::loop(
+        []() -> co::func<void>
+        {
+            co::watch<std::string> w("v0");
+            auto rx = w.subscribe();
+            REQUIRE(!rx.has_changed());
+            REQUIRE(rx.get() == "v0");
+            auto res = co_await rx.changed({ 5ms });
+            REQUIRE(res == co::timeout);
+
+            // the intermediate versions are skipped, nothing is queued
+            REQUIRE(w.publish("v1").is_ok());
+            REQUIRE(w.publish(std::string("v2")).is_ok());
+            REQUIRE(w.version() == 2);
+            REQUIRE(rx.has_changed());
+            res = co_await rx.changed();
+            REQUIRE(res.unwrap() == "v2");
+            REQUIRE(!rx.has_changed());
+
+            // a new receiver has seen the current version
+            auto late = w.subscribe();
+            REQUIRE(!late.has_changed());
+            REQUIRE(w.get() == "v2");
+
+            REQUIRE(w.publish("v3").is_ok());
+            REQUIRE(late.get() == "v3");
+            REQUIRE(!late.has_changed());
+
+            w.close();
+            REQUIRE(w.publish("v4") == co::closed);
+            // the unseen version is delivered before co::closed
+            res = co_await rx.changed();
+            REQUIRE(res.unwrap() == "v3");
+            res = co_await rx.changed();
+            REQUIRE(res == co::closed);
+            res = co_await late.changed();
+            REQUIRE(res == co::closed);
+        });
+}
+
+TEST_CASE("watch wakes up all the waiting readers", "[primitives]")
+{
+    static constexpr int n_readers = 10;
+    static constexpr int n_versions = 100;
+    std::vector<int> last_seen(n_readers, -1);
+    co::loop(
+        [&last_seen]() -> co::func<void>
+        {
+            co::watch<int> w(0);
+            std::vector<co::thread> readers;
+            for (int i = 0; i < n_readers; i++)
+            {
+                readers.emplace_back(
+                    [rx = w.subscribe(), &seen = last_seen[i]]() mutable -> co::func<void>
+                    {
+                        while (true)
+                        {
+                            auto res = co_await rx.changed();
+                            if (res == co::closed)
+                                break;
+                            // the versions never go back
+                            REQUIRE(res.unwrap() > seen);
+                            seen = res.unwrap();
+                        }
+                    });
+            }
+
+            for (int i = 1; i <= n_versions; i++)
+            {
+                REQUIRE(w.publish(i).is_ok());
+                if (i % 10 == 0)
+                    co_await co::this_thread::yield();
+            }
+            w.close();
+            for (auto& th : readers)
+                co_await th.join();
+        });
+    for (int seen : last_seen)
+        REQUIRE(seen == n_versions);
+}
+
+TEST_CASE("ts_watch between std::threads and co::threads", "[primitives]")
+{
+    static constexpr int n_versions = 1000;
+    co::ts_watch<int> w(0);
+    auto co_rx = w.subscribe();
+    int std_seen = 0;
+    std::thread std_reader(
+        [rx = w.subscribe(), &std_seen]() mutable
+        {
+            while (true)
+            {
+                auto res = rx.blocking_changed();
+                if (res == co::closed)
+                    break;
+                std_seen = res.unwrap();
+            }
+        });
+    std::thread writer(
+        [w]() mutable
+        {
+            for (int i = 1; i <= n_versions; i++)
+                w.publish(i).unwrap();
+            w.close();
+        });
+
+    int co_seen = 0;
+    co::loop(
+        [&co_rx, &co_seen]() -> co::func<void>
+        {
+            while (true)
+            {
+                auto res = co_await co_rx.changed();
+                if (res == co::closed)
+                    break;
+                REQUIRE(res.unwrap() > co_seen);
+                co_seen = res.unwrap();
+            }
+        });
+    writer.join();
+    std_reader.join();
+    REQUIRE(co_seen == n_versions);
+    REQUIRE(std_seen == n_versions);
+}
+
+TEST_CASE("ts_watch blocking_changed with a timeout", "[primitives]")
+{
+    co::ts_watch<int> w(0);
+    auto rx = w.subscribe();
+    REQUIRE(rx.blocking_changed(1ms) == co::timeout);
+
+    std::thread writer(
+        [w]() mutable
+        {
+            std::this_thread::sleep_for(5ms);
+            w.publish(42).unwrap();
+            w.close();
+        });
+    REQUIRE(rx.blocking_changed(10s).unwrap() == 42);
+    REQUIRE(rx.blocking_changed(10s) == co::closed);
+    writer.join();
+}